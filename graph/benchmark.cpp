@@ -0,0 +1,232 @@
+/**
+ * benchmark.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Construction, BFS, Dijkstra and connected components on synthetic graphs, for catching regressions and for
+ * choosing between graph representations.
+ *
+ * Usage: benchmark [scale] [rmat] [grid] [torus] [geometric] [cycle]
+ *
+ * Every graph has about 2^scale vertices (the default scale is 18), and all of the graph types are run unless
+ * some are named. For each step, it reports the time, the throughput in edges per second, and, where the kernel
+ * allows it (on Linux, with perf_event_open), the number of cache misses. The peak resident set size is reported
+ * once per graph.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/connected_components.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/visitors.hpp>
+
+#include "graph_common.h"
+#include "graph_builder.h"
+#include "generators.h"
+#include "components.h"
+
+/** A hardware cache miss counter for this thread, if the kernel lets us have one. **/
+class cache_miss_counter {
+public:
+    cache_miss_counter() {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof attr;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~cache_miss_counter() {
+#ifdef __linux__
+        if (fd_ >= 0)
+            close(fd_);
+#endif
+    }
+
+    cache_miss_counter(const cache_miss_counter &) = delete;
+    cache_miss_counter &operator=(const cache_miss_counter &) = delete;
+
+    bool available() const { return fd_ >= 0; }
+
+    void start() {
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    std::uint64_t stop() {
+        std::uint64_t count = 0;
+#ifdef __linux__
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd_, &count, sizeof count) != sizeof count)
+                count = 0;
+        }
+#endif
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+/**
+ * The peak resident set size in MB. On Linux, reset_peak_rss starts a new peak, so that each graph can be measured
+ * on its own; elsewhere, this is the peak of the whole run.
+ */
+void reset_peak_rss() {
+    std::ofstream{"/proc/self/clear_refs"} << "5";
+}
+
+double peak_rss_mb() {
+    std::ifstream status{"/proc/self/status"};
+    for (std::string line; std::getline(status, line);)
+        if (line.rfind("VmHWM:", 0) == 0)
+            return std::strtod(line.c_str() + 6, nullptr) / 1024;
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+int main(int argc, char *argv[]) {
+    const unsigned scale = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 18;
+    std::set<std::string> wanted(argv + std::min(argc, 2), argv + argc);
+    const auto run = [&](const std::string &type) { return wanted.empty() || wanted.count(type); };
+
+    const std::size_t n = std::size_t{1} << scale;
+    const auto side = static_cast<std::size_t>(std::sqrt(static_cast<double>(n)));
+
+    cache_miss_counter counter;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << std::left << std::setw(20) << "graph" << std::setw(24) << "step" << std::right
+              << std::setw(12) << "ms" << std::setw(12) << "Medges/s" << std::setw(16) << "cache misses" << std::endl;
+
+    // Runs one step, which processes the given number of edges, and prints a row for it.
+    const auto step = [&](const std::string &graph, const char *name, const std::size_t edges, auto &&f) {
+        counter.start();
+        const auto start = std::chrono::steady_clock::now();
+        auto result = f();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        const auto misses = counter.stop();
+        std::cout << std::left << std::setw(20) << graph << std::setw(24) << name << std::right
+                  << std::setw(12) << elapsed.count() << std::setw(12) << edges / elapsed.count() / 1000
+                  << std::setw(16) << (counter.available() ? std::to_string(misses) : "n/a") << std::endl;
+        return result;
+    };
+
+    const auto benchmark = [&](const auto &generate) {
+        reset_peak_rss();
+        const generated_graph input = generate();
+        const auto &name = input.name;
+        const auto m = input.edges.size();
+
+        const auto g = step(name, "build graph_t", m, [&] {
+            return build_graph(input.edges.begin(), input.edges.end(), input.num_vertices);
+        });
+        const auto csr = step(name, "build csr_graph_t", m, [&] {
+            return build_csr(input.edges.begin(), input.edges.end(), input.num_vertices);
+        });
+
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<int> wdist(1, 100);
+        std::vector<int> weights(m);
+        for (auto &w: weights)
+            w = wdist(gen);
+        const auto wcsr = step(name, "build weighted csr", m, [&] {
+            return make_weighted_csr(input.edges.begin(), input.edges.end(), weights.begin(), input.num_vertices);
+        });
+
+        // The traversals start from the vertex of highest degree, which is in the giant component if there is one,
+        // and their throughput counts the arcs of the vertices they reach.
+        std::size_t source = 0;
+        for (std::size_t v = 0; v < input.num_vertices; ++v)
+            if (boost::out_degree(v, csr) > boost::out_degree(source, csr))
+                source = v;
+        std::vector<int> distances(input.num_vertices, -1);
+        distances[source] = 0;
+        boost::breadth_first_search(csr, source,
+                boost::visitor(boost::make_bfs_visitor(
+                        boost::record_distances(distances.data(), boost::on_tree_edge{}))));
+        std::size_t reached = 0;
+        for (std::size_t v = 0; v < input.num_vertices; ++v)
+            if (distances[v] >= 0)
+                reached += boost::out_degree(v, csr);
+
+        step(name, "bfs graph_t", reached, [&] {
+            boost::breadth_first_search(g, source,
+                    boost::visitor(boost::make_bfs_visitor(
+                            boost::record_distances(distances.data(), boost::on_tree_edge{}))));
+            return 0;
+        });
+        step(name, "bfs csr_graph_t", reached, [&] {
+            boost::breadth_first_search(csr, source,
+                    boost::visitor(boost::make_bfs_visitor(
+                            boost::record_distances(distances.data(), boost::on_tree_edge{}))));
+            return 0;
+        });
+        step(name, "dijkstra weighted csr", reached, [&] {
+            boost::dijkstra_shortest_paths(wcsr, source, boost::distance_map(
+                    boost::make_iterator_property_map(distances.begin(), boost::get(boost::vertex_index, wcsr))));
+            return 0;
+        });
+
+        std::vector<std::size_t> component(input.num_vertices);
+        const auto count = step(name, "components (boost)", boost::num_edges(csr), [&] {
+            return boost::connected_components(csr, component.data());
+        });
+        step(name, "components (parallel)", boost::num_edges(csr), [&] {
+            return parallel_connected_components(csr, component.data());
+        });
+        step(name, "components (afforest)", boost::num_edges(csr), [&] {
+            return afforest_connected_components(csr, component.data());
+        });
+
+        std::cout << name << ": " << input.num_vertices << " vertices, " << m << " edges, " << count
+                  << " components, peak RSS " << peak_rss_mb() << " MB" << std::endl << std::endl;
+    };
+
+    if (run("rmat"))
+        benchmark([&] { return rmat_graph(scale); });
+    if (run("grid"))
+        benchmark([&] { return grid_graph(side, side); });
+    if (run("torus"))
+        benchmark([&] { return grid_graph(side, side, true); });
+    if (run("geometric"))
+        // An expected degree of about 10.
+        benchmark([&] { return geometric_graph(n, std::sqrt(10 / (M_PI * n))); });
+    if (run("cycle"))
+        benchmark([&] { return cycle_graph(n); });
+
+    return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * bfs_direction.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Direction-optimizing BFS compared to boost::breadth_first_search.
+ */
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/visitors.hpp>
+
+#include "graph_common.h"
+#include "graph_builder.h"
+#include "bfs_direction_optimizing.h"
+
+int main() {
+    // On a cycle, the frontier never has more than two vertices, so this is just a top-down BFS.
+    {
+        int constexpr v = 9;
+        auto g = createCn_ep(v);
+
+        std::array<int, v> distances;
+        std::array<int, v> predecessors;
+        direction_optimizing_bfs(g, 0, distances.begin(), predecessors.begin());
+
+        for (int i=0; i < v; ++i)
+            std::cout << "Vertex " << i << " has predecessor " << predecessors[i] << " and distance " << distances[i] << std::endl;
+    }
+
+    // A random graph has a small diameter, so the frontier explodes after a few levels and bottom-up pays off.
+    {
+        constexpr std::size_t v = 100000;
+        constexpr std::size_t e = 1000000;
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        for (std::size_t i = 0; i < e; ++i)
+            edges.emplace_back(vdist(gen), vdist(gen));
+        const auto g = build_csr(edges.begin(), edges.end(), v);
+
+        std::vector<int> boost_distances(v, 0);
+        boost::breadth_first_search(g, 0,
+            boost::visitor(
+                    boost::make_bfs_visitor(
+                            boost::record_distances(boost_distances.data(), boost::on_tree_edge{}))));
+
+        std::vector<int> distances(v, 0);
+        std::vector<std::size_t> predecessors(v, 0);
+        const auto inspected = direction_optimizing_bfs(g, 0, distances.data(), predecessors.data());
+
+        // Boost's BFS looks at every edge of every reachable vertex.
+        std::cout << "Edges inspected: " << inspected << " instead of " << boost::num_edges(g) << std::endl;
+        std::cout << "Same distances: " << std::boolalpha << (distances == boost_distances) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * bfs_direction_optimizing.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Direction-optimizing BFS (Beamer, Asanovic and Patterson, 2012).
+ *
+ * The usual BFS is "top-down": every vertex in the frontier looks at all of its neighbours to find the ones that
+ * haven't been discovered yet. When the frontier is huge (which happens after only a few levels in graphs with a
+ * small diameter), nearly all of those neighbours have already been discovered, so most of that work is wasted.
+ *
+ * The trick is to turn the search around when the frontier gets big, and go "bottom-up": every vertex that hasn't
+ * been discovered yet looks through its neighbours for one that is in the frontier, and stops as soon as it finds
+ * one. Once the frontier shrinks again, we go back to top-down.
+ *
+ * Bottom-up steps look at the neighbours of a vertex to find its parent, so they assume that the neighbours of v
+ * are exactly the vertices that have v as a neighbour, i.e. that the graph is undirected (graph_t) or stores every
+ * edge in both directions (csr_graph_t).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+/** A fixed-size set of vertex indices, stored one bit per vertex. **/
+class vertex_bitmap {
+public:
+    explicit vertex_bitmap(const std::size_t n) : words_((n + 63) / 64, 0) {}
+
+    bool test(const std::size_t i) const { return (words_[i / 64] >> (i % 64)) & 1u; }
+    void set(const std::size_t i) { words_[i / 64] |= std::uint64_t{1} << (i % 64); }
+    void clear() { std::fill(words_.begin(), words_.end(), 0); }
+
+private:
+    std::vector<std::uint64_t> words_;
+};
+
+/** Tuning parameters for direction_optimizing_bfs. The defaults are the ones suggested in the paper. **/
+struct direction_optimizing_params {
+    // Go bottom-up when the edges leaving the frontier exceed 1/alpha of the edges out of unvisited vertices.
+    double alpha = 15.0;
+
+    // Go back to top-down when the frontier holds fewer than 1/beta of the vertices.
+    double beta = 18.0;
+};
+
+/**
+ * Breadth-first search from s that fills in distances and predecessors the way record_distances and
+ * record_predecessors (with on_tree_edge) would: the entries for vertices that are not reachable from s are left
+ * untouched. Unlike those visitors, the entries for s itself are also set, to 0 and s respectively.
+ *
+ * The distance and predecessor maps are writable property maps, so pointers and std::array iterators work just
+ * as they do with record_distances. The return value is the number of edges inspected.
+ */
+template<typename Graph, typename DistanceMap, typename PredecessorMap>
+std::size_t direction_optimizing_bfs(const Graph &g,
+                                     const typename boost::graph_traits<Graph>::vertex_descriptor s,
+                                     DistanceMap distances,
+                                     PredecessorMap predecessors,
+                                     const direction_optimizing_params params = {}) {
+    using vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
+
+    const auto index = boost::get(boost::vertex_index, g);
+    const std::size_t n = boost::num_vertices(g);
+
+    // The edges still to be explored, which is what the frontier's edges are compared to.
+    std::size_t unexplored_edges = 0;
+    for (auto [vit, vend] = boost::vertices(g); vit != vend; ++vit)
+        unexplored_edges += boost::out_degree(*vit, g);
+
+    vertex_bitmap visited{n};
+    vertex_bitmap in_frontier{n};
+    std::vector<vertex> frontier{s};
+    std::vector<vertex> next;
+
+    visited.set(boost::get(index, s));
+    boost::put(distances, s, 0);
+    boost::put(predecessors, s, s);
+    unexplored_edges -= boost::out_degree(s, g);
+
+    std::size_t inspected = 0;
+    bool bottom_up = false;
+    for (std::size_t level = 1; !frontier.empty(); ++level) {
+        std::size_t frontier_edges = 0;
+        for (const auto u: frontier)
+            frontier_edges += boost::out_degree(u, g);
+
+        if (!bottom_up && frontier_edges > unexplored_edges / params.alpha)
+            bottom_up = true;
+        else if (bottom_up && frontier.size() < n / params.beta)
+            bottom_up = false;
+
+        next.clear();
+        if (bottom_up) {
+            in_frontier.clear();
+            for (const auto u: frontier)
+                in_frontier.set(boost::get(index, u));
+
+            // Every unvisited vertex looks for a parent in the frontier, and stops at the first one.
+            for (auto [vit, vend] = boost::vertices(g); vit != vend; ++vit) {
+                const auto v = *vit;
+                if (visited.test(boost::get(index, v)))
+                    continue;
+                for (auto [eit, eend] = boost::out_edges(v, g); eit != eend; ++eit) {
+                    ++inspected;
+                    const auto u = boost::target(*eit, g);
+                    if (in_frontier.test(boost::get(index, u))) {
+                        visited.set(boost::get(index, v));
+                        boost::put(distances, v, level);
+                        boost::put(predecessors, v, u);
+                        next.push_back(v);
+                        break;
+                    }
+                }
+            }
+        } else {
+            // Every frontier vertex claims all of its unvisited neighbours.
+            for (const auto u: frontier)
+                for (auto [eit, eend] = boost::out_edges(u, g); eit != eend; ++eit) {
+                    ++inspected;
+                    const auto v = boost::target(*eit, g);
+                    const auto vi = boost::get(index, v);
+                    if (visited.test(vi))
+                        continue;
+                    visited.set(vi);
+                    boost::put(distances, v, level);
+                    boost::put(predecessors, v, u);
+                    next.push_back(v);
+                }
+        }
+
+        for (const auto v: next)
+            unexplored_edges -= boost::out_degree(v, g);
+        frontier.swap(next);
+    }
+
+    return inspected;
+}
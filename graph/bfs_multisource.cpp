@@ -0,0 +1,88 @@
+/**
+ * bfs_multisource.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Running many BFSes at once: all-pairs hop counts and closeness centrality.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/visitors.hpp>
+
+#include "graph_common.h"
+#include "graph_builder.h"
+#include "bfs_multisource.h"
+
+int main() {
+    // All-pairs hop counts on C8, where every vertex is a source.
+    {
+        int constexpr v = 8;
+        auto g = createCn_ep(v);
+
+        std::vector<vertex_t> sources(v);
+        std::iota(sources.begin(), sources.end(), 0);
+        const auto distances = multi_source_bfs(g, sources);
+
+        auto oiter = std::ostream_iterator<int>(std::cout, " ");
+        for (const auto &row: distances) {
+            std::copy(row.begin(), row.end(), oiter);
+            std::cout << std::endl;
+        }
+    }
+
+    // Closeness centrality (the inverse of the average distance to the other vertices) of 256 vertices of a random
+    // graph, compared to running one BFS per vertex.
+    {
+        constexpr std::size_t v = 50000;
+        constexpr std::size_t e = 250000;
+        constexpr std::size_t k = 256;
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        for (std::size_t i = 0; i < e; ++i)
+            edges.emplace_back(vdist(gen), vdist(gen));
+        const auto g = build_csr(edges.begin(), edges.end(), v);
+
+        std::vector<std::size_t> sources(k);
+        std::iota(sources.begin(), sources.end(), 0);
+
+        const auto closeness = [](const std::vector<int> &row) {
+            double total = 0;
+            for (const auto d: row)
+                if (d > 0)
+                    total += d;
+            return total > 0 ? (row.size() - 1) / total : 0.0;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::vector<int>> single(k, std::vector<int>(v, -1));
+        for (std::size_t i = 0; i < k; ++i) {
+            single[i][sources[i]] = 0;
+            boost::breadth_first_search(g, sources[i],
+                boost::visitor(
+                        boost::make_bfs_visitor(
+                                boost::record_distances(single[i].data(), boost::on_tree_edge{}))));
+        }
+        const std::chrono::duration<double, std::milli> single_time = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        const auto batched = multi_source_bfs<256>(g, sources);
+        const std::chrono::duration<double, std::milli> batched_time = std::chrono::steady_clock::now() - start;
+
+        std::cout << "Closeness of vertex 0: " << closeness(batched[0]) << std::endl;
+        std::cout << "One BFS per source: " << single_time.count() << " ms" << std::endl;
+        std::cout << "Batched:            " << batched_time.count() << " ms" << std::endl;
+        std::cout << "Same distances: " << std::boolalpha << (single == batched) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * bfs_multisource.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Bit-parallel BFS from many sources at once (Then et al., "The More the Merrier", 2014).
+ *
+ * Running one BFS per source means walking the same adjacency lists over and over. Instead, we give each source a
+ * bit, and store for every vertex a word with one bit per source that has seen it. A single sweep over the edges
+ * then advances all of the searches by one level: a vertex passes on to its neighbours every bit of its word that
+ * it received on the previous level, and a neighbour keeps only the bits it hasn't seen before.
+ *
+ * The width of the words is a template parameter: 64 sources use a single uint64_t, and wider batches use several.
+ * The operations on them are simple loops over the words, which the compiler can vectorize (e.g. 256 sources fit one AVX2 register).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+/** A set of up to Lanes sources, one bit per source. **/
+template<std::size_t Lanes>
+class source_set {
+    static_assert(Lanes % 64 == 0, "Lanes must be a multiple of 64.");
+
+public:
+    static constexpr std::size_t words = Lanes / 64;
+
+    void set(const std::size_t i) { bits_[i / 64] |= std::uint64_t{1} << (i % 64); }
+
+    bool any() const {
+        std::uint64_t result = 0;
+        for (std::size_t w = 0; w < words; ++w)
+            result |= bits_[w];
+        return result != 0;
+    }
+
+    source_set &operator|=(const source_set &other) {
+        for (std::size_t w = 0; w < words; ++w)
+            bits_[w] |= other.bits_[w];
+        return *this;
+    }
+
+    /** Keep only the bits that are not in other. **/
+    source_set &remove(const source_set &other) {
+        for (std::size_t w = 0; w < words; ++w)
+            bits_[w] &= ~other.bits_[w];
+        return *this;
+    }
+
+    /** Call f(i) for each set bit i. **/
+    template<typename F>
+    void for_each(F &&f) const {
+        for (std::size_t w = 0; w < words; ++w)
+            for (auto b = bits_[w]; b; b &= b - 1)
+                f(w * 64 + __builtin_ctzll(b));
+    }
+
+private:
+    std::array<std::uint64_t, words> bits_{};
+};
+
+/**
+ * Compute the BFS distances from each of the given sources to every vertex in g, where result[i][v] is the
+ * distance from sources[i] to v, or -1 if v isn't reachable from sources[i]. These are the values record_distances
+ * would have produced from one breadth_first_search per source (with the arrays initialized to -1, and 0 for the
+ * source itself).
+ *
+ * The sources are processed Lanes at a time. The graph must be undirected (or store every edge in both directions),
+ * have a vertex_index property mapping vertices to 0..n-1, and vertex(i, g) must return the vertex with index i.
+ */
+template<std::size_t Lanes = 64, typename Graph>
+std::vector<std::vector<int>> multi_source_bfs(const Graph &g,
+        const std::vector<typename boost::graph_traits<Graph>::vertex_descriptor> &sources) {
+    const auto index = boost::get(boost::vertex_index, g);
+    const std::size_t n = boost::num_vertices(g);
+
+    std::vector<std::vector<int>> result(sources.size(), std::vector<int>(n, -1));
+
+    std::vector<source_set<Lanes>> seen(n);
+    std::vector<source_set<Lanes>> visit(n);
+    std::vector<source_set<Lanes>> visit_next(n);
+
+    for (std::size_t batch = 0; batch < sources.size(); batch += Lanes) {
+        const std::size_t batch_size = std::min(Lanes, sources.size() - batch);
+        std::fill(seen.begin(), seen.end(), source_set<Lanes>{});
+        std::fill(visit.begin(), visit.end(), source_set<Lanes>{});
+
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            const auto si = boost::get(index, sources[batch + i]);
+            seen[si].set(i);
+            visit[si].set(i);
+            result[batch + i][si] = 0;
+        }
+
+        for (int level = 1;; ++level) {
+            // Push every vertex's new bits to its neighbours.
+            for (std::size_t ui = 0; ui < n; ++ui) {
+                if (!visit[ui].any())
+                    continue;
+                for (auto [eit, eend] = boost::out_edges(boost::vertex(ui, g), g); eit != eend; ++eit)
+                    visit_next[boost::get(index, boost::target(*eit, g))] |= visit[ui];
+            }
+
+            // Keep only the bits that each vertex is seeing for the first time: for those sources, it is at
+            // distance level.
+            bool any = false;
+            for (std::size_t vi = 0; vi < n; ++vi) {
+                auto &next = visit_next[vi];
+                next.remove(seen[vi]);
+                if (!next.any())
+                    continue;
+                any = true;
+                seen[vi] |= next;
+                next.for_each([&](const std::size_t i) { result[batch + i][vi] = level; });
+            }
+            if (!any)
+                break;
+
+            visit.swap(visit_next);
+            std::fill(visit_next.begin(), visit_next.end(), source_set<Lanes>{});
+        }
+    }
+
+    return result;
+}
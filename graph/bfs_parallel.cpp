@@ -0,0 +1,66 @@
+/**
+ * bfs_parallel.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * BFS across several threads, producing the same distances and predecessors as bfs_distpaths.
+ */
+
+#include <array>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/visitors.hpp>
+
+#include "graph_common.h"
+#include "graph_builder.h"
+#include "bfs_parallel.h"
+
+int main() {
+    {
+        int constexpr v = 9;
+        auto g = createCn_ep(v);
+
+        std::array<int, v> distances;
+        std::array<int, v> predecessors;
+        parallel_bfs(g, 0, distances.begin(), predecessors.begin(), {4, true});
+
+        for (int i=0; i < v; ++i)
+            std::cout << "Vertex " << i << " has predecessor " << predecessors[i] << " and distance " << distances[i] << std::endl;
+    }
+
+    {
+        constexpr std::size_t v = 100000;
+        constexpr std::size_t e = 1000000;
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        for (std::size_t i = 0; i < e; ++i)
+            edges.emplace_back(vdist(gen), vdist(gen));
+        const auto g = build_csr(edges.begin(), edges.end(), v);
+
+        std::vector<int> boost_distances(v, 0);
+        boost::breadth_first_search(g, 0,
+            boost::visitor(
+                    boost::make_bfs_visitor(
+                            boost::record_distances(boost_distances.data(), boost::on_tree_edge{}))));
+
+        // With deterministic set, the predecessors don't depend on how the threads were scheduled.
+        std::vector<int> distances(v, 0);
+        std::vector<std::size_t> predecessors1(v, 0);
+        std::vector<std::size_t> predecessors2(v, 0);
+        parallel_bfs(g, 0, distances.data(), predecessors1.data(), {8, true});
+        parallel_bfs(g, 0, distances.data(), predecessors2.data(), {3, true});
+
+        std::cout << std::boolalpha;
+        std::cout << "Same distances: " << (distances == boost_distances) << std::endl;
+        std::cout << "Same predecessors: " << (predecessors1 == predecessors2) << std::endl;
+    }
+
+    return 0;
+}
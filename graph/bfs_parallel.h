@@ -0,0 +1,173 @@
+/**
+ * bfs_parallel.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Level-synchronous parallel BFS.
+ *
+ * BFS proceeds one level at a time: all of the vertices at distance d are found before any at distance d+1. The
+ * vertices in one level can be expanded independently, so we split each level between a fixed set of worker
+ * threads, and wait for all of them to finish before starting on the next level.
+ *
+ * Two threads may find the same undiscovered vertex at the same time, so vertices are claimed with an atomic
+ * compare-and-swap: only the thread that wins the claim adds the vertex to the next level.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+/** A reusable barrier: every thread calling wait() blocks until all of them have called it. **/
+class thread_barrier {
+public:
+    explicit thread_barrier(const std::size_t count) : count_{count}, waiting_{0}, generation_{0} {}
+
+    void wait() {
+        std::unique_lock<std::mutex> lock{mutex_};
+        const auto generation = generation_;
+        if (++waiting_ == count_) {
+            waiting_ = 0;
+            ++generation_;
+            cv_.notify_all();
+        } else
+            cv_.wait(lock, [&] { return generation != generation_; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    const std::size_t count_;
+    std::size_t waiting_;
+    std::size_t generation_;
+};
+
+/** Options for parallel_bfs. **/
+struct parallel_bfs_params {
+    // The number of worker threads. 0 means one per core.
+    unsigned threads = 0;
+
+    // When more than one vertex in a level is adjacent to a newly discovered vertex, which one becomes its
+    // predecessor depends on which thread gets there first. If deterministic is set, the one with the smallest
+    // vertex index is always chosen instead, so that the predecessors are the same from one run to the next.
+    // This costs an extra atomic operation per edge into the next level.
+    bool deterministic = false;
+
+    // The number of frontier vertices a thread takes at a time.
+    std::size_t grain = 256;
+};
+
+/**
+ * Breadth-first search from s using several threads. The distance and predecessor maps are filled in the way
+ * record_distances and record_predecessors (with on_tree_edge) would fill them, except that the entries for s are
+ * also set to 0 and s. Entries for unreachable vertices are left untouched.
+ *
+ * The maps are only written to after the search has finished, from the calling thread, so they don't need to be
+ * thread-safe. The graph must have a vertex_index property mapping vertices to 0..n-1, and vertex(i, g) must
+ * return the vertex with index i, as is the case for graph_t and csr_graph_t.
+ */
+template<typename Graph, typename DistanceMap, typename PredecessorMap>
+void parallel_bfs(const Graph &g,
+                  const typename boost::graph_traits<Graph>::vertex_descriptor s,
+                  DistanceMap distances,
+                  PredecessorMap predecessors,
+                  const parallel_bfs_params params = {}) {
+    using vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
+    constexpr auto unclaimed = std::numeric_limits<std::size_t>::max();
+
+    const auto index = boost::get(boost::vertex_index, g);
+    const std::size_t n = boost::num_vertices(g);
+    const unsigned threads = params.threads ? params.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    // level[v] is the distance from s to v, or unclaimed if v hasn't been discovered yet. Claiming a vertex means
+    // swapping its level from unclaimed to the next level. parent[v] is the index of the predecessor of v.
+    std::vector<std::atomic<std::size_t>> level(n);
+    std::vector<std::atomic<std::size_t>> parent(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        level[i].store(unclaimed, std::memory_order_relaxed);
+        parent[i].store(unclaimed, std::memory_order_relaxed);
+    }
+    level[boost::get(index, s)] = 0;
+    parent[boost::get(index, s)] = boost::get(index, s);
+
+    std::vector<vertex> frontier{s};
+    std::vector<std::vector<vertex>> next(threads);
+    std::atomic<std::size_t> cursor{0};
+    std::size_t depth = 0;
+    bool done = false;
+    thread_barrier barrier{threads};
+
+    const auto worker = [&](const unsigned t) {
+        while (true) {
+            // Take chunks of the frontier until there are none left.
+            for (std::size_t begin; (begin = cursor.fetch_add(params.grain)) < frontier.size();) {
+                const auto end = std::min(begin + params.grain, frontier.size());
+                for (auto i = begin; i < end; ++i) {
+                    const auto u = frontier[i];
+                    const std::size_t ui = boost::get(index, u);
+                    for (auto [eit, eend] = boost::out_edges(u, g); eit != eend; ++eit) {
+                        const std::size_t vi = boost::get(index, boost::target(*eit, g));
+
+                        auto claimed = level[vi].load(std::memory_order_relaxed);
+                        if (claimed == unclaimed && level[vi].compare_exchange_strong(claimed, depth + 1)) {
+                            next[t].push_back(boost::target(*eit, g));
+                            if (!params.deterministic) {
+                                parent[vi].store(ui, std::memory_order_relaxed);
+                                continue;
+                            }
+                            claimed = depth + 1;
+                        }
+
+                        // Every frontier neighbour of a vertex claimed on this level competes to be its parent,
+                        // and the smallest index wins, no matter which thread claimed the vertex.
+                        if (params.deterministic && claimed == depth + 1) {
+                            auto current = parent[vi].load(std::memory_order_relaxed);
+                            while (ui < current && !parent[vi].compare_exchange_weak(current, ui));
+                        }
+                    }
+                }
+            }
+
+            barrier.wait();
+            if (t == 0) {
+                frontier.clear();
+                for (auto &nt: next) {
+                    frontier.insert(frontier.end(), nt.begin(), nt.end());
+                    nt.clear();
+                }
+                cursor = 0;
+                ++depth;
+                done = frontier.empty();
+            }
+            barrier.wait();
+            if (done)
+                return;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (auto &w: workers)
+        w.join();
+
+    for (std::size_t vi = 0; vi < n; ++vi) {
+        const auto d = level[vi].load(std::memory_order_relaxed);
+        if (d == unclaimed)
+            continue;
+        const auto v = boost::vertex(vi, g);
+        boost::put(distances, v, d);
+        boost::put(predecessors, v, boost::vertex(parent[vi].load(std::memory_order_relaxed), g));
+    }
+}
@@ -0,0 +1,66 @@
+/**
+ * bulk_build.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Building large graphs from edge lists in bulk, compared to adding edges one at a time.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+
+#include "graph_common.h"
+#include "graph_builder.h"
+
+int main() {
+    constexpr std::size_t v = 200000;
+    constexpr std::size_t e = 2000000;
+
+    // A random edge list. With this many edges over this few vertices, there will be some duplicates,
+    // in both directions.
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    edges.reserve(e);
+    for (std::size_t i = 0; i < e; ++i)
+        edges.emplace_back(vdist(gen), vdist(gen));
+
+    // Times a function and reports how long it took.
+    const auto timed = [](const char *name, auto &&f) {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = f();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << name << ": " << elapsed.count() << " ms" << std::endl;
+        return result;
+    };
+
+    // The slow way: one add_edge at a time.
+    const auto g1 = timed("add_edge", [&] {
+        graph_t g{v};
+        for (const auto &[s, t]: edges)
+            boost::add_edge(s, t, g);
+        return g;
+    });
+
+    // graph_t still inserts every edge into a set, so the bulk path saves it little; vec_graph_t and the CSR graph
+    // take the sorted, deduplicated edges as they come.
+    const auto g2 = timed("build_graph<graph_t>", [&] { return build_graph(edges.begin(), edges.end(), v); });
+    const auto g3 = timed("build_graph<vec_graph_t>", [&] {
+        return build_graph<vec_graph_t>(edges.begin(), edges.end(), v);
+    });
+    const auto g4 = timed("build_csr", [&] { return build_csr(edges.begin(), edges.end(), v); });
+
+    // The adjacency lists store each undirected edge once, but the CSR graph stores both directions.
+    // (The exception is self-loops, which the CSR graph stores once, so the last count may be a little lower.)
+    std::cout << "Edges: " << boost::num_edges(g1) << " / " << boost::num_edges(g2) << " / " << boost::num_edges(g3)
+              << " / " << boost::num_edges(g4) / 2 << std::endl;
+    std::cout << "Threads: " << default_threads() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * compact.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * CSR graphs with 32-bit vertices and narrow weights, used by the same BFS and Dijkstra calls as the wide ones.
+ */
+
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/visitors.hpp>
+
+#include "graph_common.h"
+#include "graph_builder.h"
+
+/** Bytes used by the offset, target and weight arrays of a CSR graph, given the size of a weight. **/
+template<typename Graph>
+std::size_t csr_bytes(const Graph &g, const std::size_t weight_size = 0) {
+    return (boost::num_vertices(g) + 1) * sizeof(typename Graph::edges_size_type)
+           + boost::num_edges(g) * (sizeof(typename Graph::vertex_descriptor) + weight_size);
+}
+
+int main() {
+    constexpr std::size_t v = 200000;
+    constexpr std::size_t e = 1000000;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+    std::uniform_int_distribution<int> wdist(1, 1000);
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    std::vector<int> weights;
+    for (std::size_t i = 0; i < e; ++i) {
+        edges.emplace_back(vdist(gen), vdist(gen));
+        weights.emplace_back(wdist(gen));
+    }
+
+    std::cout << "Vertex descriptor: " << sizeof(csr_graph_t::vertex_descriptor) << " vs "
+              << sizeof(compact_csr_graph_t::vertex_descriptor) << " bytes" << std::endl;
+    std::cout << "Edge descriptor:   " << sizeof(csr_graph_t::edge_descriptor) << " vs "
+              << sizeof(compact_csr_graph_t::edge_descriptor) << " bytes" << std::endl;
+
+    // BFS: the same call on both, but the compact graph also gets 32-bit predecessors.
+    {
+        const auto wide = build_csr(edges.begin(), edges.end(), v);
+        const auto narrow = build_csr<compact_csr_graph_t>(edges.begin(), edges.end(), v);
+        std::cout << "Unweighted graph: " << csr_bytes(wide) << " vs " << csr_bytes(narrow) << " bytes" << std::endl;
+
+        std::vector<int> wide_distances(v, 0);
+        std::vector<std::size_t> wide_predecessors(v, 0);
+        boost::breadth_first_search(wide, 0,
+            boost::visitor(
+                    boost::make_bfs_visitor(
+                            std::make_pair(
+                                    boost::record_distances(wide_distances.data(), boost::on_tree_edge{}),
+                                    boost::record_predecessors(wide_predecessors.data(), boost::on_tree_edge{})))));
+
+        std::vector<int> narrow_distances(v, 0);
+        std::vector<std::uint32_t> narrow_predecessors(v, 0);
+        boost::breadth_first_search(narrow, 0,
+            boost::visitor(
+                    boost::make_bfs_visitor(
+                            std::make_pair(
+                                    boost::record_distances(narrow_distances.data(), boost::on_tree_edge{}),
+                                    boost::record_predecessors(narrow_predecessors.data(), boost::on_tree_edge{})))));
+
+        std::cout << "Same BFS distances: " << std::boolalpha << (wide_distances == narrow_distances) << std::endl;
+    }
+
+    // Dijkstra: int weights against float and uint16_t weights.
+    {
+        const auto wide = make_weighted_csr(edges.begin(), edges.end(), weights.begin(), v);
+        using float_graph = compact_weighted_csr_graph_t;
+        using short_graph = weighted_csr_graph_of<std::uint16_t, std::uint32_t>;
+        const auto as_float = make_weighted_csr<float_graph>(edges.begin(), edges.end(), weights.begin(), v);
+        const auto as_short = make_weighted_csr<short_graph>(edges.begin(), edges.end(), weights.begin(), v);
+        std::cout << "Weighted graph: " << csr_bytes(wide, sizeof(int)) << " vs " << csr_bytes(as_float, sizeof(float))
+                  << " vs " << csr_bytes(as_short, sizeof(std::uint16_t)) << " bytes" << std::endl;
+
+        std::vector<int> wide_distances(v);
+        boost::dijkstra_shortest_paths(wide, 0, boost::distance_map(
+                boost::make_iterator_property_map(wide_distances.begin(), boost::get(boost::vertex_index, wide))));
+
+        std::vector<float> float_distances(v);
+        std::vector<std::uint32_t> float_directions(v);
+        boost::dijkstra_shortest_paths(as_float, 0,
+                boost::predecessor_map(
+                        boost::make_iterator_property_map(float_directions.begin(), boost::get(boost::vertex_index, as_float)))
+                .distance_map(
+                        boost::make_iterator_property_map(float_distances.begin(), boost::get(boost::vertex_index, as_float))));
+
+        // The distances would overflow 16 bits, so they get a wider map than the weights.
+        std::vector<std::uint32_t> short_distances(v);
+        std::vector<std::uint32_t> short_directions(v);
+        boost::dijkstra_shortest_paths(as_short, 0,
+                boost::predecessor_map(
+                        boost::make_iterator_property_map(short_directions.begin(), boost::get(boost::vertex_index, as_short)))
+                .distance_map(
+                        boost::make_iterator_property_map(short_distances.begin(), boost::get(boost::vertex_index, as_short))));
+
+        // Unreachable vertices are left at the maximum of each distance type.
+        bool same = true;
+        for (std::size_t i = 0; i < v; ++i) {
+            if (wide_distances[i] == std::numeric_limits<int>::max())
+                same = same && float_distances[i] == std::numeric_limits<float>::max()
+                       && short_distances[i] == std::numeric_limits<std::uint32_t>::max();
+            else
+                same = same && wide_distances[i] == static_cast<int>(float_distances[i])
+                       && wide_distances[i] == static_cast<int>(short_distances[i]);
+        }
+        std::cout << "Same Dijkstra distances: " << same << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,80 @@
+/**
+ * components.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Connected components by union-find: in parallel, with Afforest, and kept up to date as edges are added.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/connected_components.hpp>
+
+#include "graph_common.h"
+#include "components.h"
+
+int main() {
+    std::cout.setf(std::ios::boolalpha);
+
+    // The house from graph.cpp: a square, and then a roof added one edge at a time.
+    {
+        auto g = createCn_ve(4);
+        auto components = incremental_components::of(g);
+        std::cout << "Square: " << components.count() << " component(s)" << std::endl;
+        add_tracked_edge(3, 4, g, components);
+        std::cout << "After adding 3-4: " << components.count() << " component(s), 0 and 4 connected: "
+                  << components.connected(0, 4) << std::endl;
+        add_tracked_edge(2, 4, g, components);
+        std::cout << "After adding 2-4: " << components.count() << " component(s)" << std::endl;
+        components.add_vertex();
+        std::cout << "With a lonely vertex 5: " << components.count() << " component(s), 0 and 5 connected: "
+                  << components.connected(0, 5) << std::endl << std::endl;
+    }
+
+    // A large sparse random graph, with a giant component and some isolated vertices.
+    constexpr std::size_t v = 1000000;
+    constexpr std::size_t e = 4000000;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for (std::size_t i = 0; i < e; ++i)
+        edges.emplace_back(vdist(gen), vdist(gen));
+    const auto g = make_csr(edges.begin(), edges.end(), v);
+
+    // Times a function and reports how long it took.
+    const auto timed = [](const char *name, auto &&f) {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = f();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << name << ": " << elapsed.count() << " ms, " << result << " components" << std::endl;
+        return result;
+    };
+
+    std::vector<std::size_t> expected(v);
+    timed("boost::connected_components", [&] { return boost::connected_components(g, expected.data()); });
+
+    // Boost numbers the components in DFS order, which here is also the order of their smallest vertex.
+    std::vector<std::size_t> component(v);
+    timed("parallel_connected_components", [&] { return parallel_connected_components(g, component.data()); });
+    std::cout << "Same components: " << (component == expected) << std::endl;
+
+    std::fill(component.begin(), component.end(), 0);
+    timed("afforest_connected_components", [&] { return afforest_connected_components(g, component.data()); });
+    std::cout << "Same components: " << (component == expected) << std::endl;
+
+    // Routing requests only need to know whether the two ends are connected.
+    auto tracked = incremental_components{v};
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto &[s, t]: edges)
+        tracked.add_edge(s, t);
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "incremental_components: " << elapsed.count() << " ms, " << tracked.count() << " components, "
+              << "giant component of " << tracked.component_size(edges.front().first) << " vertices" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,287 @@
+/**
+ * components.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Connected components with union-find, in three flavours.
+ *
+ * boost::connected_components runs a DFS over the whole graph on one thread, and has to be run again from scratch
+ * whenever an edge is added. Union-find (disjoint sets) instead merges the components of the two ends of each
+ * edge, in any order, which makes it easy both to split between threads and to keep up to date:
+ *
+ * 1. parallel_connected_components splits the edges between threads, which merge sets in a lock-free
+ *    concurrent_union_find.
+ *
+ * 2. incremental_components keeps the components of a growing graph, one add_edge at a time (see
+ *    add_tracked_edge), and answers "are u and v connected?" in nearly constant time.
+ *
+ * 3. afforest_connected_components (Sutton, Ben-Nun and Barak, 2018) is a refinement of Shiloach-Vishkin for huge
+ *    graphs. It first links every vertex to just its first couple of neighbours, which is usually enough to form
+ *    most of the giant component that real graphs have. Then it samples vertices to find that component, and only
+ *    the vertices outside it look at the rest of their edges: most of the edges are never read at all.
+ *
+ * The parallel versions number the components 0, 1, ... in the order of their smallest vertex, so the result
+ * doesn't depend on the number of threads, and return the number of components, like boost::connected_components.
+ * They need a vertex_index property mapping vertices to 0..n-1, and vertex(i, g) must return the vertex with index
+ * i. Afforest assumes that every edge can be seen from both ends, as in an undirected graph or a CSR graph built
+ * with make_csr.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+/**
+ * Disjoint sets over 0..n-1 that any number of threads can merge and query at once, without locks.
+ *
+ * The root of a set is always its smallest element: unite hangs the larger root under the smaller one, with a
+ * compare-and-swap that fails (and retries) if another thread got there first. Finds halve the path as they go,
+ * which is safe to race on, since they only ever replace a parent with one of its ancestors.
+ */
+class concurrent_union_find {
+public:
+    explicit concurrent_union_find(const std::size_t n) : parent_(n) {
+        for (std::size_t i = 0; i < n; ++i)
+            parent_[i].store(i, std::memory_order_relaxed);
+    }
+
+    std::size_t size() const { return parent_.size(); }
+
+    std::size_t find(std::size_t x) {
+        while (true) {
+            auto p = parent_[x].load(std::memory_order_relaxed);
+            if (p == x)
+                return x;
+            const auto gp = parent_[p].load(std::memory_order_relaxed);
+            if (gp != p)
+                parent_[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            x = gp;
+        }
+    }
+
+    /** Merge the sets of a and b, returning false if they were already the same set. **/
+    bool unite(std::size_t a, std::size_t b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+                return false;
+            if (a < b)
+                std::swap(a, b);
+            auto expected = a;
+            if (parent_[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel))
+                return true;
+        }
+    }
+
+    /** Whether a and b are in the same set. Safe to call while other threads are uniting. **/
+    bool same(std::size_t a, std::size_t b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+                return true;
+            // If a is still a root, a and b really were apart at the moment of the check.
+            if (parent_[a].load(std::memory_order_acquire) == a)
+                return false;
+        }
+    }
+
+private:
+    std::vector<std::atomic<std::size_t>> parent_;
+};
+
+namespace detail {
+    /** Call f(begin, end) on one slice of [0, n) per thread, and wait for all of them. **/
+    template<typename F>
+    void parallel_slices(const std::size_t n, unsigned threads, F &&f) {
+        threads = std::max(1u, threads ? threads : std::thread::hardware_concurrency());
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < threads; ++t)
+            workers.emplace_back([&, t] { f(n * t / threads, n * (t + 1) / threads); });
+        f(0, n / threads);
+        for (auto &w: workers)
+            w.join();
+    }
+
+    /** Number the sets in the order of their smallest element (i.e. their root), and write the numbers out. **/
+    template<typename Graph, typename ComponentMap>
+    std::size_t label_components(const Graph &g, concurrent_union_find &sets, ComponentMap component) {
+        const auto n = sets.size();
+        std::vector<std::size_t> label(n);
+        std::size_t count = 0;
+        for (std::size_t v = 0; v < n; ++v) {
+            const auto root = sets.find(v);
+            label[v] = root == v ? count++ : label[root];
+            boost::put(component, boost::vertex(v, g), label[v]);
+        }
+        return count;
+    }
+}
+
+/**
+ * Compute the connected components of g with several threads (0 means one per core), writing each vertex's
+ * component number into the component map. Returns the number of components.
+ */
+template<typename Graph, typename ComponentMap>
+std::size_t parallel_connected_components(const Graph &g, ComponentMap component, const unsigned threads = 0) {
+    const auto index = boost::get(boost::vertex_index, g);
+    concurrent_union_find sets{boost::num_vertices(g)};
+    detail::parallel_slices(boost::num_vertices(g), threads, [&](const std::size_t begin, const std::size_t end) {
+        for (auto v = begin; v < end; ++v)
+            for (auto [eit, eend] = boost::out_edges(boost::vertex(v, g), g); eit != eend; ++eit)
+                sets.unite(v, boost::get(index, boost::target(*eit, g)));
+    });
+    return detail::label_components(g, sets, component);
+}
+
+/** Options for afforest_connected_components. **/
+struct afforest_params {
+    // The number of worker threads. 0 means one per core.
+    unsigned threads = 0;
+
+    // How many neighbours of each vertex to link before looking for the giant component.
+    unsigned neighbour_rounds = 2;
+
+    // How many vertices to sample when looking for the giant component.
+    std::size_t samples = 1024;
+};
+
+/** As parallel_connected_components, but skipping most of the edges of the largest component with Afforest. **/
+template<typename Graph, typename ComponentMap>
+std::size_t afforest_connected_components(const Graph &g, ComponentMap component, const afforest_params params = {}) {
+    const auto index = boost::get(boost::vertex_index, g);
+    const std::size_t n = boost::num_vertices(g);
+    concurrent_union_find sets{n};
+
+    // Link each vertex to its r-th neighbour, one round at a time.
+    for (unsigned r = 0; r < params.neighbour_rounds; ++r)
+        detail::parallel_slices(n, params.threads, [&](const std::size_t begin, const std::size_t end) {
+            for (auto v = begin; v < end; ++v) {
+                auto [eit, eend] = boost::out_edges(boost::vertex(v, g), g);
+                for (unsigned i = 0; i < r && eit != eend; ++i)
+                    ++eit;
+                if (eit != eend)
+                    sets.unite(v, boost::get(index, boost::target(*eit, g)));
+            }
+        });
+
+    // Guess the giant component from a sample.
+    std::size_t giant = n;
+    if (n > 0) {
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<std::size_t> vdist(0, n - 1);
+        std::unordered_map<std::size_t, std::size_t> seen;
+        std::size_t best = 0;
+        for (std::size_t i = 0; i < params.samples; ++i) {
+            const auto root = sets.find(vdist(gen));
+            if (++seen[root] > best) {
+                best = seen[root];
+                giant = root;
+            }
+        }
+    }
+
+    // Everything outside the giant component links the rest of its edges. Edges between the giant component and
+    // the rest are seen from the other end.
+    detail::parallel_slices(n, params.threads, [&](const std::size_t begin, const std::size_t end) {
+        for (auto v = begin; v < end; ++v) {
+            if (sets.find(v) == giant)
+                continue;
+            auto [eit, eend] = boost::out_edges(boost::vertex(v, g), g);
+            for (unsigned i = 0; i < params.neighbour_rounds && eit != eend; ++i)
+                ++eit;
+            for (; eit != eend; ++eit)
+                sets.unite(v, boost::get(index, boost::target(*eit, g)));
+        }
+    });
+
+    return detail::label_components(g, sets, component);
+}
+
+/**
+ * The connected components of a graph that only ever grows. Call add_vertex and add_edge alongside the graph's
+ * own (or use add_tracked_edge), and connected and count are always up to date. Edges can't be removed.
+ *
+ * This is the sequential union-find, with union by size and path compression.
+ */
+class incremental_components {
+public:
+    explicit incremental_components(const std::size_t n = 0) {
+        for (std::size_t v = 0; v < n; ++v)
+            add_vertex();
+    }
+
+    /** Start tracking the components of an existing graph. **/
+    template<typename Graph>
+    static incremental_components of(const Graph &g) {
+        const auto index = boost::get(boost::vertex_index, g);
+        incremental_components result{boost::num_vertices(g)};
+        for (auto [eit, eend] = boost::edges(g); eit != eend; ++eit)
+            result.add_edge(boost::get(index, boost::source(*eit, g)), boost::get(index, boost::target(*eit, g)));
+        return result;
+    }
+
+    std::size_t add_vertex() {
+        parent_.emplace_back(parent_.size());
+        size_.emplace_back(1);
+        ++count_;
+        return parent_.size() - 1;
+    }
+
+    /** Record an edge, adding any vertices it needs. Returns true if it merged two components. **/
+    bool add_edge(const std::size_t u, const std::size_t v) {
+        while (parent_.size() <= std::max(u, v))
+            add_vertex();
+        auto a = find(u);
+        auto b = find(v);
+        if (a == b)
+            return false;
+        if (size_[a] < size_[b])
+            std::swap(a, b);
+        parent_[b] = a;
+        size_[a] += size_[b];
+        --count_;
+        return true;
+    }
+
+    bool connected(const std::size_t u, const std::size_t v) { return find(u) == find(v); }
+
+    /** The size of the component of v. **/
+    std::size_t component_size(const std::size_t v) { return size_[find(v)]; }
+
+    /** The number of components. **/
+    std::size_t count() const { return count_; }
+
+    std::size_t find(std::size_t x) {
+        auto root = x;
+        while (parent_[root] != root)
+            root = parent_[root];
+        while (parent_[x] != root)
+            x = std::exchange(parent_[x], root);
+        return root;
+    }
+
+private:
+    std::vector<std::size_t> parent_;
+    std::vector<std::size_t> size_;
+    std::size_t count_ = 0;
+};
+
+/** boost::add_edge(u, v, g), recording the edge in the components as well. **/
+template<typename Graph>
+auto add_tracked_edge(const std::size_t u, const std::size_t v, Graph &g, incremental_components &components) {
+    components.add_edge(u, v);
+    return boost::add_edge(u, v, g);
+}
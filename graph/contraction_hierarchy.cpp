@@ -0,0 +1,84 @@
+/**
+ * contraction_hierarchy.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Preprocessing a road-like graph into a contraction hierarchy, saving it, and querying it.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+
+#include "graph_common.h"
+#include "dijkstra_p2p.h"
+#include "contraction_hierarchy.h"
+
+int main() {
+    // A W x H grid with random weights is a reasonable stand-in for a road network.
+    constexpr int W = 150;
+    constexpr int H = 150;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> wdist(1, 100);
+    std::vector<std::pair<int, int>> edges;
+    std::vector<int> weights;
+    for (int y = 0; y < H; ++y)
+        for (int x = 0; x < W; ++x) {
+            if (x + 1 < W) {
+                edges.emplace_back(y * W + x, y * W + x + 1);
+                weights.emplace_back(wdist(gen));
+            }
+            if (y + 1 < H) {
+                edges.emplace_back(y * W + x, (y + 1) * W + x);
+                weights.emplace_back(wdist(gen));
+            }
+        }
+    const weighted_graph_t g(edges.begin(), edges.end(), weights.begin(), W * H);
+
+    // Preprocess once, and write the result to disk.
+    auto start = std::chrono::steady_clock::now();
+    contraction_hierarchy::build(g).save("ch.bin");
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Preprocessing: " << elapsed.count() << " ms" << std::endl;
+
+    // A query process would just load it.
+    const auto ch = contraction_hierarchy::load("ch.bin");
+    std::cout << "Arcs: " << ch.num_arcs() << " for " << boost::num_edges(g) << " edges" << std::endl;
+
+    std::uniform_int_distribution<std::size_t> vdist(0, W * H - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    for (int i = 0; i < 1000; ++i)
+        pairs.emplace_back(vdist(gen), vdist(gen));
+
+    dijkstra_workspace<weighted_graph_t> workspace{g};
+    std::vector<long> expected;
+    start = std::chrono::steady_clock::now();
+    for (const auto &[s, t]: pairs)
+        expected.emplace_back(*workspace.bidirectional_shortest_path(s, t));
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Bidirectional Dijkstra: " << elapsed.count() * 1000 / pairs.size() << " us per query" << std::endl;
+
+    ch_query query{ch};
+    std::vector<long> found;
+    start = std::chrono::steady_clock::now();
+    for (const auto &[s, t]: pairs)
+        found.emplace_back(*query.distance(s, t));
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Contraction hierarchy:  " << elapsed.count() * 1000 / pairs.size() << " us per query" << std::endl;
+    std::cout << "Same distances: " << std::boolalpha << (expected == found) << std::endl;
+
+    // The unpacked path only uses original edges, and adds up to the distance.
+    query.distance(pairs[0].first, pairs[0].second);
+    const auto path = query.path();
+    long length = 0;
+    for (std::size_t i = 0; i + 1 < path.size(); ++i)
+        length += boost::get(boost::edge_weight, g, boost::edge(path[i], path[i + 1], g).first);
+    std::cout << "Path of " << path.size() << " vertices with length " << length << " (expected "
+              << expected[0] << ")" << std::endl;
+
+    return 0;
+}
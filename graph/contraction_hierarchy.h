@@ -0,0 +1,387 @@
+/**
+ * contraction_hierarchy.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Contraction hierarchies (Geisberger, Sanders, Schultes and Delling, 2008) for fast shortest path queries on a
+ * static, undirected, weighted graph.
+ *
+ * Preprocessing puts the vertices in order of "importance" and removes ("contracts") them one at a time, least
+ * important first. When a vertex v is contracted, any shortest path u - v - w through it would be lost, so a
+ * shortcut edge u - w with the same length is added, unless a witness search finds a path from u to w that is at
+ * least as short without v. The result is the original graph plus the shortcuts, and the order.
+ *
+ * Every shortest path then has a version that first only goes up in the order, and then only goes down. A query
+ * runs Dijkstra upwards from both s and t, which only ever looks at a few hundred vertices even on huge road
+ * networks, and the best vertex seen by both searches is where the path peaks. Shortcuts remember the vertex they
+ * skip, so the path can be unpacked back into original edges.
+ *
+ * The hierarchy is stored with Boost.Serialization, so it can be built once offline and loaded by every query
+ * process.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+#include <boost/serialization/vector.hpp>
+
+/** The augmented graph and vertex order produced by contraction. **/
+class contraction_hierarchy {
+public:
+    using weight_type = long;
+    static constexpr auto none = std::numeric_limits<std::size_t>::max();
+
+    /** An edge to a more important vertex. If it is a shortcut, middle is the vertex it skips. **/
+    struct arc {
+        std::size_t target;
+        weight_type weight;
+        std::size_t middle;
+
+        template<typename Archive>
+        void serialize(Archive &ar, const unsigned int version) {
+            ar & target & weight & middle;
+        }
+    };
+
+    /** Tuning parameters for preprocessing. **/
+    struct params {
+        // The number of vertices a witness search may settle before giving up and adding the shortcut anyway.
+        // Smaller limits make preprocessing faster, but add unnecessary shortcuts.
+        std::size_t witness_settle_limit = 500;
+    };
+
+    contraction_hierarchy() = default;
+
+    /** Contract g, using the weights in weight. **/
+    template<typename Graph, typename WeightMap>
+    static contraction_hierarchy build(const Graph &g, WeightMap weight, params p);
+
+    /** Contract g, using its edge_weight_t property. **/
+    template<typename Graph>
+    static contraction_hierarchy build(const Graph &g) {
+        return build(g, boost::get(boost::edge_weight, g), params{});
+    }
+
+    std::size_t num_vertices() const { return rank_.size(); }
+    std::size_t num_arcs() const { return arcs_.size(); }
+
+    /** The position of v in the contraction order: higher means more important. **/
+    std::size_t rank(const std::size_t v) const { return rank_[v]; }
+
+    /** The arcs from v to more important vertices. **/
+    std::pair<const arc*, const arc*> upward(const std::size_t v) const {
+        return {arcs_.data() + offsets_[v], arcs_.data() + offsets_[v + 1]};
+    }
+
+    /** The shortest arc between u and w, in either direction. There must be one. **/
+    const arc &find(std::size_t u, std::size_t w) const {
+        if (rank_[u] > rank_[w])
+            std::swap(u, w);
+        const arc *best = nullptr;
+        for (auto [it, end] = upward(u); it != end; ++it)
+            if (it->target == w && (!best || it->weight < best->weight))
+                best = it;
+        return *best;
+    }
+
+    void save(const std::string &filename) const {
+        std::ofstream file{filename, std::ios::binary};
+        boost::archive::binary_oarchive oa{file};
+        oa << *this;
+    }
+
+    static contraction_hierarchy load(const std::string &filename) {
+        std::ifstream file{filename, std::ios::binary};
+        boost::archive::binary_iarchive ia{file};
+        contraction_hierarchy ch;
+        ia >> ch;
+        return ch;
+    }
+
+private:
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int version) {
+        ar & rank_ & offsets_ & arcs_;
+    }
+
+    std::vector<std::size_t> rank_;
+
+    // The upward arcs of vertex v are arcs_[offsets_[v]] to arcs_[offsets_[v+1]].
+    std::vector<std::size_t> offsets_;
+    std::vector<arc> arcs_;
+};
+
+template<typename Graph, typename WeightMap>
+contraction_hierarchy contraction_hierarchy::build(const Graph &g, WeightMap weight, const params p) {
+    using entry = std::pair<weight_type, std::size_t>;
+    const auto index = boost::get(boost::vertex_index, g);
+    const std::size_t n = boost::num_vertices(g);
+
+    // The remaining graph, which shrinks as vertices are contracted and grows shortcuts.
+    std::vector<std::vector<arc>> adjacent(n);
+    for (auto [eit, eend] = boost::edges(g); eit != eend; ++eit) {
+        const std::size_t u = boost::get(index, boost::source(*eit, g));
+        const std::size_t w = boost::get(index, boost::target(*eit, g));
+        if (u == w)
+            continue;
+        const weight_type wt = boost::get(weight, *eit);
+        adjacent[u].push_back({w, wt, none});
+        adjacent[w].push_back({u, wt, none});
+    }
+
+    std::vector<char> contracted(n, 0);
+    std::vector<std::size_t> contracted_neighbours(n, 0);
+
+    // Witness search state, reset after every search by remembering what was touched.
+    std::vector<weight_type> dist(n, std::numeric_limits<weight_type>::max());
+    std::vector<std::size_t> touched;
+    std::priority_queue<entry, std::vector<entry>, std::greater<>> heap;
+
+    // Dijkstra from u, avoiding v, up to distance limit.
+    const auto witness_search = [&](const std::size_t u, const std::size_t v, const weight_type limit) {
+        for (const auto x: touched)
+            dist[x] = std::numeric_limits<weight_type>::max();
+        touched.clear();
+        heap = {};
+
+        dist[u] = 0;
+        touched.push_back(u);
+        heap.emplace(0, u);
+        for (std::size_t settled = 0; !heap.empty() && settled < p.witness_settle_limit; ++settled) {
+            const auto [d, x] = heap.top();
+            heap.pop();
+            if (d > limit)
+                break;
+            if (d != dist[x])
+                continue;
+            for (const auto &a: adjacent[x]) {
+                if (a.target == v || contracted[a.target])
+                    continue;
+                if (d + a.weight < dist[a.target]) {
+                    if (dist[a.target] == std::numeric_limits<weight_type>::max())
+                        touched.push_back(a.target);
+                    dist[a.target] = d + a.weight;
+                    heap.emplace(dist[a.target], a.target);
+                }
+            }
+        }
+    };
+
+    // The shortcuts that contracting v would need, with middle temporarily holding the other endpoint.
+    std::vector<arc> shortcuts;
+    const auto find_shortcuts = [&](const std::size_t v) {
+        shortcuts.clear();
+        auto &neighbours = adjacent[v];
+        for (const auto &in: neighbours) {
+            if (contracted[in.target])
+                continue;
+
+            weight_type limit = 0;
+            for (const auto &out: neighbours)
+                if (!contracted[out.target] && out.target != in.target)
+                    limit = std::max(limit, in.weight + out.weight);
+            witness_search(in.target, v, limit);
+
+            // Each pair is considered from both ends, so only keep the shortcut from the smaller vertex.
+            for (const auto &out: neighbours)
+                if (!contracted[out.target] && in.target < out.target
+                    && in.weight + out.weight < dist[out.target])
+                    shortcuts.push_back({out.target, in.weight + out.weight, in.target});
+        }
+    };
+
+    // Importance: the edge difference (shortcuts added minus edges removed), plus the contracted neighbours so
+    // that contraction spreads out evenly over the graph.
+    const auto priority = [&](const std::size_t v) {
+        find_shortcuts(v);
+        long removed = 0;
+        for (const auto &a: adjacent[v])
+            removed += !contracted[a.target];
+        return static_cast<long>(shortcuts.size()) - removed + static_cast<long>(contracted_neighbours[v]);
+    };
+
+    std::priority_queue<std::pair<long, std::size_t>, std::vector<std::pair<long, std::size_t>>, std::greater<>> order;
+    for (std::size_t v = 0; v < n; ++v)
+        order.emplace(priority(v), v);
+
+    contraction_hierarchy ch;
+    ch.rank_.resize(n);
+    std::vector<std::vector<arc>> upward(n);
+
+    for (std::size_t next_rank = 0; !order.empty();) {
+        const auto v = order.top().second;
+        order.pop();
+
+        // Priorities go stale as the graph changes: recompute lazily, and put v back if it is no longer the least
+        // important.
+        const auto current = priority(v);
+        if (!order.empty() && current > order.top().first) {
+            order.emplace(current, v);
+            continue;
+        }
+
+        // find_shortcuts(v) was just run by priority(v), so the shortcuts are ready to add.
+        for (auto s: shortcuts) {
+            const auto u = s.middle;
+            s.middle = v;
+            adjacent[u].push_back(s);
+            adjacent[s.target].push_back({u, s.weight, v});
+        }
+
+        for (const auto &a: adjacent[v])
+            if (!contracted[a.target]) {
+                upward[v].push_back(a);
+                ++contracted_neighbours[a.target];
+            }
+        contracted[v] = 1;
+        ch.rank_[v] = next_rank++;
+
+        // The contracted vertex's edges won't be looked at again.
+        adjacent[v] = std::vector<arc>{};
+    }
+
+    ch.offsets_.push_back(0);
+    for (std::size_t v = 0; v < n; ++v) {
+        ch.arcs_.insert(ch.arcs_.end(), upward[v].begin(), upward[v].end());
+        ch.offsets_.push_back(ch.arcs_.size());
+    }
+    return ch;
+}
+
+/**
+ * Point-to-point queries against a contraction hierarchy. Like dijkstra_workspace, this keeps its arrays between
+ * queries and only resets the entries a query touched. It is not thread-safe: use one per thread.
+ */
+class ch_query {
+public:
+    using weight_type = contraction_hierarchy::weight_type;
+
+    explicit ch_query(const contraction_hierarchy &ch)
+            : ch_{ch}, forward_{ch.num_vertices()}, backward_{ch.num_vertices()} {}
+
+    /** The length of the shortest path from s to t, or nothing if there is none. **/
+    std::optional<weight_type> distance(const std::size_t s, const std::size_t t) {
+        forward_.run(ch_, s);
+        backward_.run(ch_, t);
+        source_ = s;
+        target_ = t;
+
+        // The peak of the path is the vertex reached by both searches that minimizes the total distance.
+        weight_type best = infinity;
+        peak_ = none;
+        for (const auto v: forward_.touched)
+            if (backward_.dist[v] != infinity && forward_.dist[v] + backward_.dist[v] < best) {
+                best = forward_.dist[v] + backward_.dist[v];
+                peak_ = v;
+            }
+
+        if (peak_ == none)
+            return std::nullopt;
+        return best;
+    }
+
+    /** The vertices of the path found by the last query, from s to t, with the shortcuts unpacked. **/
+    std::vector<std::size_t> path() const {
+        std::vector<std::size_t> result;
+        if (peak_ == none)
+            return result;
+
+        // The upward halves of the path, each from the peak downwards.
+        std::vector<std::size_t> up;
+        for (auto v = peak_; v != source_; v = forward_.pred[v])
+            up.push_back(v);
+        up.push_back(source_);
+        std::vector<std::size_t> down;
+        for (auto v = peak_; v != target_; v = backward_.pred[v])
+            down.push_back(v);
+        down.push_back(target_);
+
+        result.push_back(source_);
+        for (auto i = up.size() - 1; i > 0; --i)
+            unpack(up[i], up[i - 1], result);
+        for (std::size_t i = 0; i + 1 < down.size(); ++i)
+            unpack(down[i], down[i + 1], result);
+        return result;
+    }
+
+private:
+    static constexpr auto infinity = std::numeric_limits<weight_type>::max();
+    static constexpr auto none = contraction_hierarchy::none;
+
+    /** Append the original vertices on the arc from u to w (excluding u) to out. **/
+    void unpack(const std::size_t u, const std::size_t w, std::vector<std::size_t> &out) const {
+        const auto &a = ch_.find(u, w);
+        if (a.middle == none) {
+            out.push_back(w);
+            return;
+        }
+        unpack(u, a.middle, out);
+        unpack(a.middle, w, out);
+    }
+
+    /** A Dijkstra search that only follows upward arcs, with a resettable workspace. **/
+    struct upward_search {
+        using entry = std::pair<weight_type, std::size_t>;
+
+        explicit upward_search(const std::size_t n) : dist(n, infinity), pred(n, none) {}
+
+        std::vector<weight_type> dist;
+        std::vector<std::size_t> pred;
+        std::vector<std::size_t> touched;
+        std::vector<entry> heap;
+
+        void run(const contraction_hierarchy &ch, const std::size_t s) {
+            for (const auto v: touched) {
+                dist[v] = infinity;
+                pred[v] = none;
+            }
+            touched.clear();
+            heap.clear();
+
+            dist[s] = 0;
+            touched.push_back(s);
+            heap.emplace_back(0, s);
+            while (!heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+                const auto [d, u] = heap.back();
+                heap.pop_back();
+                if (d != dist[u])
+                    continue;
+                for (auto [it, end] = ch.upward(u); it != end; ++it) {
+                    if (d + it->weight >= dist[it->target])
+                        continue;
+                    if (dist[it->target] == infinity)
+                        touched.push_back(it->target);
+                    dist[it->target] = d + it->weight;
+                    pred[it->target] = u;
+                    heap.emplace_back(dist[it->target], it->target);
+                    std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+                }
+            }
+        }
+    };
+
+    const contraction_hierarchy &ch_;
+    upward_search forward_;
+    upward_search backward_;
+    std::size_t source_ = none;
+    std::size_t target_ = none;
+    std::size_t peak_ = none;
+};
@@ -0,0 +1,52 @@
+/**
+ * csr.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Running BFS and Dijkstra over a compressed sparse row graph.
+ */
+
+#include <array>
+#include <iostream>
+
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/visitors.hpp>
+
+#include "graph_common.h"
+
+int main() {
+    int constexpr v = 8;
+
+    // The CSR graph models the same concepts as graph_t, so the algorithms don't care which one they get.
+    // Since we stored each undirected edge in both directions, there are twice as many (directed) edges.
+    auto g = createCn_csr(v);
+    std::cout << "Number of vertices: " << boost::num_vertices(g) << std::endl;
+    std::cout << "Number of edges:    " << boost::num_edges(g) << std::endl;
+
+    std::array<int, v> distances{{0}};
+    std::array<int, v> predecessors{{0}};
+    boost::breadth_first_search(g, topLeft,
+        boost::visitor(
+                boost::make_bfs_visitor(
+                        std::make_pair(
+                                boost::record_distances(distances.begin(), boost::on_tree_edge{}),
+                                boost::record_predecessors(predecessors.begin(), boost::on_tree_edge{})))));
+
+    for (int i=0; i < v; ++i)
+        std::cout << "Vertex " << i << " has predecessor " << predecessors[i] << " and distance " << distances[i] << std::endl;
+
+    // The weights live in their own contiguous array, and the edge_weight_t property map finds them just as it
+    // would for weighted_graph_t.
+    std::array<int, v> directions;
+    std::array<int, v> weights{{1, 3, 2, 4, 3, 1, 2, 3}};
+    auto wg = createCn_weighted_csr(weights);
+    boost::dijkstra_shortest_paths(wg, 0, boost::predecessor_map(directions.begin()));
+
+    for (auto i = 0; i < v; ++i)
+        std::cout << i << ": " << directions[i] << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * delta_stepping.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Parallel single-source shortest paths by delta-stepping (Meyer and Sanders, 2003).
+ *
+ * Dijkstra's algorithm settles one vertex at a time, which leaves nothing to do in parallel. Delta-stepping
+ * instead groups the vertices into buckets of width delta by tentative distance, and processes a whole bucket at
+ * once: every vertex in the bucket relaxes its edges at the same time.
+ *
+ * An edge is "light" if its weight is at most delta, and "heavy" otherwise. Relaxing a light edge can put a vertex
+ * back into the bucket being processed, so light edges are relaxed in rounds until the bucket stays empty. Heavy
+ * edges can only reach later buckets, so they are relaxed once, after the bucket is finished.
+ *
+ * With a small delta this is Dijkstra's algorithm, and with a huge one it is Bellman-Ford. In between, a delta
+ * around the average weight divided by the average degree is usually a good place to start.
+ *
+ * To avoid locking, every vertex is owned by exactly one thread (vertex i belongs to thread i % threads), and only
+ * the owner ever changes its distance or bucket. Threads relax the edges of the vertices they own and send the
+ * resulting requests to the owners of the targets, who apply them in the next phase.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <boost/graph/exception.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include "bfs_parallel.h"
+
+/** Options for delta_stepping_shortest_paths. **/
+struct delta_stepping_params {
+    // The width of a bucket.
+    double delta = 1.0;
+
+    // The number of worker threads. 0 means one per core.
+    unsigned threads = 0;
+};
+
+/**
+ * Compute the shortest paths from s, like boost::dijkstra_shortest_paths(g, s, params), but with several threads.
+ * The supported named parameters are predecessor_map, distance_map and weight_map, e.g.
+ *
+ *     delta_stepping_shortest_paths(g, 0,
+ *             boost::predecessor_map(directions.begin()).weight_map(boost::get(&edge_properties::weight, g)),
+ *             {0.5});
+ *
+ * As with Boost, every vertex that is unreachable from s is its own predecessor, and has the maximum distance.
+ * The maps are only written to after the search has finished, from the calling thread. The graph must have a
+ * vertex_index property mapping vertices to 0..n-1, and vertex(i, g) must return the vertex with index i.
+ *
+ * Throws std::invalid_argument if delta isn't positive, and, like Boost, boost::negative_edge if any weight is
+ * negative.
+ */
+template<typename Graph, typename Param, typename Tag, typename Rest>
+void delta_stepping_shortest_paths(const Graph &g,
+                                   const typename boost::graph_traits<Graph>::vertex_descriptor s,
+                                   const boost::bgl_named_params<Param, Tag, Rest> &named,
+                                   const delta_stepping_params params = {}) {
+    const auto weight = boost::choose_const_pmap(boost::get_param(named, boost::edge_weight), g, boost::edge_weight);
+    using weight_type = typename boost::property_traits<std::decay_t<decltype(weight)>>::value_type;
+    using distance_type = std::conditional_t<std::is_floating_point_v<weight_type>, weight_type, double>;
+    constexpr auto infinity = std::numeric_limits<distance_type>::max();
+
+    const auto index = boost::get(boost::vertex_index, g);
+    const std::size_t n = boost::num_vertices(g);
+    const unsigned threads = params.threads ? params.threads : std::max(1u, std::thread::hardware_concurrency());
+    const double delta = params.delta;
+    if (!(delta > 0))
+        throw std::invalid_argument("delta_stepping_shortest_paths: delta must be positive");
+    for (auto [eit, eend] = boost::edges(g); eit != eend; ++eit)
+        if (boost::get(weight, *eit) < 0)
+            throw boost::negative_edge();
+
+    const auto owner = [&](const std::size_t vi) { return vi % threads; };
+    const auto bucket_of = [&](const distance_type d) { return static_cast<std::size_t>(std::floor(d / delta)); };
+
+    std::vector<distance_type> dist(n, infinity);
+    std::vector<std::size_t> pred(n);
+    for (std::size_t vi = 0; vi < n; ++vi)
+        pred[vi] = vi;
+
+    // The distance each vertex had the last time it relaxed its light edges, so that it doesn't do so twice.
+    std::vector<distance_type> expanded(n, infinity);
+
+    // Whether each vertex has been settled in the current bucket, and so has heavy edges still to relax.
+    std::vector<char> in_settled(n, 0);
+
+    // buckets[t] holds the non-empty buckets of thread t's vertices. A vertex may be left behind in a bucket
+    // after its distance improves: such stale entries are skipped.
+    std::vector<std::map<std::size_t, std::vector<std::size_t>>> buckets(threads);
+
+    // requests[from][to] holds the relaxations that thread from has found for the vertices owned by thread to.
+    using request = std::tuple<std::size_t, distance_type, std::size_t>;
+    std::vector<std::vector<std::vector<request>>> requests(threads, std::vector<std::vector<request>>(threads));
+
+    // Per-thread state for the current bucket: the vertices to relax, the ones settled so far, whether the bucket
+    // has been refilled, and the next non-empty bucket.
+    std::vector<std::vector<std::size_t>> current(threads);
+    std::vector<std::vector<std::size_t>> settled(threads);
+    std::vector<char> refilled(threads, 0);
+    std::vector<std::size_t> next_bucket(threads);
+
+    const auto si = boost::get(index, s);
+    dist[si] = 0;
+    buckets[owner(si)][0].push_back(si);
+
+    thread_barrier barrier{threads};
+
+    const auto worker = [&](const unsigned t) {
+        // Relax the edges of the given vertices whose weights are on the requested side of delta.
+        const auto relax = [&](const std::vector<std::size_t> &from, const bool light) {
+            for (const auto ui: from)
+                for (auto [eit, eend] = boost::out_edges(boost::vertex(ui, g), g); eit != eend; ++eit) {
+                    const distance_type w = boost::get(weight, *eit);
+                    if ((w <= delta) != light)
+                        continue;
+                    const std::size_t vi = boost::get(index, boost::target(*eit, g));
+                    requests[t][owner(vi)].emplace_back(vi, dist[ui] + w, ui);
+                }
+        };
+
+        // Apply the requests sent to this thread, and report whether bucket b received any vertices.
+        const auto apply = [&](const std::size_t b) {
+            for (unsigned from = 0; from < threads; ++from) {
+                for (const auto &[vi, d, ui]: requests[from][t])
+                    if (d < dist[vi]) {
+                        dist[vi] = d;
+                        pred[vi] = ui;
+                        buckets[t][bucket_of(d)].push_back(vi);
+                    }
+                requests[from][t].clear();
+            }
+            const auto it = buckets[t].find(b);
+            refilled[t] = it != buckets[t].end() && !it->second.empty();
+        };
+
+        const auto any_refilled = [&] {
+            return std::any_of(refilled.begin(), refilled.end(), [](const char r) { return r != 0; });
+        };
+
+        std::size_t b = 0;
+        while (true) {
+            // Light edges: keep emptying the bucket until no thread puts anything back into it.
+            do {
+                current[t].clear();
+                if (auto it = buckets[t].find(b); it != buckets[t].end()) {
+                    for (const auto vi: it->second)
+                        if (bucket_of(dist[vi]) == b && expanded[vi] != dist[vi]) {
+                            expanded[vi] = dist[vi];
+                            current[t].push_back(vi);
+                            if (!in_settled[vi]) {
+                                in_settled[vi] = 1;
+                                settled[t].push_back(vi);
+                            }
+                        }
+                    buckets[t].erase(it);
+                }
+                relax(current[t], true);
+                barrier.wait();
+                apply(b);
+                barrier.wait();
+            } while (any_refilled());
+
+            // Heavy edges, once per settled vertex.
+            relax(settled[t], false);
+            barrier.wait();
+            apply(b);
+            for (const auto vi: settled[t])
+                in_settled[vi] = 0;
+            settled[t].clear();
+
+            // Move on to the first non-empty bucket of any thread.
+            next_bucket[t] = buckets[t].empty() ? std::numeric_limits<std::size_t>::max() : buckets[t].begin()->first;
+            barrier.wait();
+            b = *std::min_element(next_bucket.begin(), next_bucket.end());
+            barrier.wait();
+            if (b == std::numeric_limits<std::size_t>::max())
+                return;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (auto &w: workers)
+        w.join();
+
+    const auto predecessor = boost::choose_param(boost::get_param(named, boost::vertex_predecessor),
+                                                 boost::dummy_property_map());
+    auto distance = boost::choose_param(boost::get_param(named, boost::vertex_distance), boost::dummy_property_map());
+    using distance_value = typename boost::property_traits<decltype(distance)>::value_type;
+    for (std::size_t vi = 0; vi < n; ++vi) {
+        const auto v = boost::vertex(vi, g);
+        boost::put(predecessor, v, boost::vertex(pred[vi], g));
+        if constexpr (std::is_arithmetic_v<distance_value>)
+            boost::put(distance, v, dist[vi] == infinity
+                                    ? std::numeric_limits<distance_value>::max()
+                                    : static_cast<distance_value>(dist[vi]));
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * dijkstra_integer.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Dijkstra's algorithm with integer priority queues instead of a heap.
+ */
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/named_function_params.hpp>
+
+#include "graph_common.h"
+#include "dijkstra_integer.h"
+
+/** Counts the vertices that Dijkstra examines. **/
+struct examine_counter : boost::default_dijkstra_visitor {
+    std::size_t *count;
+
+    explicit examine_counter(std::size_t *count) : count{count} {}
+
+    template<typename Vertex, typename Graph>
+    void examine_vertex(Vertex, const Graph &) { ++*count; }
+};
+
+int main() {
+    // The same query as in dijkstra_paths, with the same named parameters.
+    {
+        int constexpr v = 8;
+        std::array<int, v> directions;
+        std::array<int, v> weights{{1, 3, 2, 4, 3, 1, 2, 3}};
+
+        weighted_graph_t g = createCn_weighted(weights);
+        integer_dijkstra_shortest_paths(g, 0, boost::predecessor_map(directions.begin()));
+
+        for (auto i = 0; i < v; ++i)
+            std::cout << i << ": " << directions[i] << std::endl;
+    }
+
+    // With a visitor, the parameters go to boost::dijkstra_shortest_paths, so the visitor sees every event.
+    {
+        std::array<int, 8> weights{{1, 3, 2, 4, 3, 1, 2, 3}};
+        weighted_graph_t g = createCn_weighted(weights);
+        std::size_t examined = 0;
+        const auto queue = integer_dijkstra_shortest_paths(g, 0, boost::visitor(examine_counter{&examined}));
+        std::cout << "With a visitor: " << (queue == dijkstra_queue::heap ? "heap" : "integer queue") << ", "
+                  << examined << " vertices examined" << std::endl;
+    }
+
+    // A random graph with small weights (Dial's algorithm) and with large weights (a radix heap).
+    const auto names = std::array<const char*, 3>{"dial", "radix", "heap"};
+    for (const int max_weight: {100, 1000000}) {
+        constexpr std::size_t v = 200000;
+        constexpr std::size_t e = 1000000;
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+        std::uniform_int_distribution<int> wdist(0, max_weight);
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        std::vector<int> weights;
+        for (std::size_t i = 0; i < e; ++i) {
+            edges.emplace_back(vdist(gen), vdist(gen));
+            weights.emplace_back(wdist(gen));
+        }
+        const weighted_graph_t g(edges.begin(), edges.end(), weights.begin(), v);
+
+        std::vector<int> boost_distances(v);
+        auto start = std::chrono::steady_clock::now();
+        boost::dijkstra_shortest_paths(g, 0, boost::distance_map(boost_distances.data()));
+        const std::chrono::duration<double, std::milli> boost_time = std::chrono::steady_clock::now() - start;
+
+        std::vector<int> distances(v);
+        std::vector<std::size_t> predecessors(v);
+        start = std::chrono::steady_clock::now();
+        const auto queue = integer_dijkstra_shortest_paths(g, 0,
+                boost::predecessor_map(predecessors.data()).distance_map(distances.data()));
+        const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+
+        std::cout << "Weights up to " << max_weight << ": " << names[static_cast<int>(queue)] << " took "
+                  << time.count() << " ms, heap took " << boost_time.count() << " ms, same distances: "
+                  << std::boolalpha << (distances == boost_distances) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,249 @@
+/**
+ * dijkstra_integer.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Dijkstra's algorithm specialized for small non-negative integer weights.
+ *
+ * boost::dijkstra_shortest_paths uses a d-ary heap, which works for any weight type, but costs O(log n) per
+ * operation. When the weights are integers, there are cheaper priority queues that exploit the fact that the
+ * distances Dijkstra extracts never decrease:
+ *
+ * 1. Dial's bucket queue: if every weight is at most C, then every tentative distance in the queue lies in
+ *    [d, d + C], where d is the last distance extracted. A circular array of C + 1 buckets, indexed by distance
+ *    modulo C + 1, holds them, and both push and pop are O(1) (amortized over the scan of empty buckets).
+ *
+ * 2. A radix heap: bucket i holds the keys that first differ from the last extracted key in bit i - 1. A key only
+ *    ever moves to lower buckets, so each key is moved at most once per bit, and the operations are O(log C)
+ *    amortized, with only a handful of small vectors instead of a heap of pointers.
+ *
+ * integer_dijkstra_shortest_paths picks Dial's algorithm when the largest weight is small, a radix heap when it
+ * isn't, and falls back to boost::dijkstra_shortest_paths when the weights aren't non-negative integers.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+/** The priority queue that integer_dijkstra_shortest_paths ended up using. **/
+enum class dijkstra_queue {
+    dial, radix, heap
+};
+
+/** Dial's circular bucket queue, for keys that never exceed the last key popped by more than max_weight. **/
+template<typename Value>
+class bucket_queue {
+public:
+    explicit bucket_queue(const std::uint64_t max_weight) : buckets_(max_weight + 1) {}
+
+    bool empty() const { return size_ == 0; }
+
+    void push(const std::uint64_t key, const Value value) {
+        buckets_[key % buckets_.size()].emplace_back(key, value);
+        ++size_;
+    }
+
+    std::pair<std::uint64_t, Value> pop() {
+        while (buckets_[current_].empty())
+            current_ = (current_ + 1) % buckets_.size();
+        const auto top = buckets_[current_].back();
+        buckets_[current_].pop_back();
+        --size_;
+        return top;
+    }
+
+private:
+    std::vector<std::vector<std::pair<std::uint64_t, Value>>> buckets_;
+    std::size_t current_ = 0;
+    std::size_t size_ = 0;
+};
+
+/** A monotone radix heap: no key pushed may be less than the last key popped. **/
+template<typename Value>
+class radix_heap {
+public:
+    bool empty() const { return size_ == 0; }
+
+    void push(const std::uint64_t key, const Value value) {
+        buckets_[bucket(key)].emplace_back(key, value);
+        ++size_;
+    }
+
+    std::pair<std::uint64_t, Value> pop() {
+        if (buckets_[0].empty()) {
+            // Find the first non-empty bucket, make its smallest key the new last key, and spread its entries over
+            // the lower buckets: they all now differ from last_ in a lower bit.
+            std::size_t i = 1;
+            while (buckets_[i].empty())
+                ++i;
+            auto &from = buckets_[i];
+            last_ = std::min_element(from.begin(), from.end())->first;
+            for (const auto &entry: from)
+                buckets_[bucket(entry.first)].push_back(entry);
+            from.clear();
+        }
+        const auto top = buckets_[0].back();
+        buckets_[0].pop_back();
+        --size_;
+        return top;
+    }
+
+private:
+    std::size_t bucket(const std::uint64_t key) const {
+        return key == last_ ? 0 : 64 - __builtin_clzll(key ^ last_);
+    }
+
+    std::vector<std::pair<std::uint64_t, Value>> buckets_[65];
+    std::uint64_t last_ = 0;
+    std::size_t size_ = 0;
+};
+
+/**
+ * The largest weight for which Dial's algorithm is used. Beyond this, the scan over empty buckets starts to cost
+ * more than the radix heap's redistribution.
+ */
+constexpr std::uint64_t dial_max_weight = 4096;
+
+namespace detail {
+    /** Dijkstra's algorithm over one of the monotone integer queues above. **/
+    template<typename Queue, typename Graph, typename WeightMap, typename PredecessorMap, typename DistanceMap>
+    void monotone_dijkstra(const Graph &g,
+                           const typename boost::graph_traits<Graph>::vertex_descriptor s,
+                           Queue queue,
+                           WeightMap weight,
+                           PredecessorMap predecessor,
+                           DistanceMap distance) {
+        using distance_type = typename boost::property_traits<DistanceMap>::value_type;
+        constexpr auto infinity = std::numeric_limits<std::uint64_t>::max();
+
+        const auto index = boost::get(boost::vertex_index, g);
+        std::vector<std::uint64_t> dist(boost::num_vertices(g), infinity);
+
+        // Like boost::dijkstra_shortest_paths, every vertex starts as its own predecessor.
+        for (auto [vit, vend] = boost::vertices(g); vit != vend; ++vit) {
+            boost::put(predecessor, *vit, *vit);
+            boost::put(distance, *vit, std::numeric_limits<distance_type>::max());
+        }
+
+        dist[boost::get(index, s)] = 0;
+        boost::put(distance, s, 0);
+        queue.push(0, s);
+
+        while (!queue.empty()) {
+            const auto [d, u] = queue.pop();
+
+            // Entries are never removed or decreased in the queue: a vertex is pushed again instead, and the stale
+            // entries are skipped here.
+            if (d != dist[boost::get(index, u)])
+                continue;
+
+            for (auto [eit, eend] = boost::out_edges(u, g); eit != eend; ++eit) {
+                const auto v = boost::target(*eit, g);
+                const auto vi = boost::get(index, v);
+                const auto dv = d + static_cast<std::uint64_t>(boost::get(weight, *eit));
+                if (dv < dist[vi]) {
+                    dist[vi] = dv;
+                    boost::put(distance, v, static_cast<distance_type>(dv));
+                    boost::put(predecessor, v, u);
+                    queue.push(dv, v);
+                }
+            }
+        }
+    }
+}
+
+namespace detail {
+    /** Whether the named parameters include the one with the given tag. **/
+    template<typename Params, typename Tag>
+    constexpr bool has_param = !std::is_same_v<
+            std::decay_t<decltype(boost::get_param(std::declval<const Params &>(), Tag{}))>, boost::param_not_found>;
+
+    /** Whether any parameter that the integer queues ignore was given, so that only Boost can honour them all. **/
+    template<typename Params>
+    constexpr bool needs_boost_dijkstra = has_param<Params, boost::graph_visitor_t>
+                                          || has_param<Params, boost::distance_compare_t>
+                                          || has_param<Params, boost::distance_combine_t>
+                                          || has_param<Params, boost::distance_inf_t>
+                                          || has_param<Params, boost::distance_zero_t>
+                                          || has_param<Params, boost::vertex_index_t>
+                                          || has_param<Params, boost::vertex_color_t>;
+}
+
+/** Run Dijkstra's algorithm with the integer queue appropriate for the largest weight. **/
+template<typename Graph, typename WeightMap, typename PredecessorMap, typename DistanceMap>
+dijkstra_queue run_integer_dijkstra(const Graph &g,
+                                    const typename boost::graph_traits<Graph>::vertex_descriptor s,
+                                    const std::uint64_t max_weight,
+                                    WeightMap weight,
+                                    PredecessorMap predecessor,
+                                    DistanceMap distance) {
+    using vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
+    if (max_weight <= dial_max_weight) {
+        detail::monotone_dijkstra(g, s, bucket_queue<vertex>{max_weight}, weight, predecessor, distance);
+        return dijkstra_queue::dial;
+    }
+    detail::monotone_dijkstra(g, s, radix_heap<vertex>{}, weight, predecessor, distance);
+    return dijkstra_queue::radix;
+}
+
+/**
+ * A drop-in replacement for boost::dijkstra_shortest_paths(g, s, params), e.g.
+ *
+ *     integer_dijkstra_shortest_paths(g, 0, boost::predecessor_map(directions.begin()));
+ *
+ * The integer queues only support the named parameters predecessor_map, distance_map and weight_map. If the
+ * weights are integers, all of them are non-negative, and the largest is at most dial_max_weight, Dial's
+ * algorithm is used; with larger integer weights, a radix heap. Otherwise, or if any other parameter that
+ * boost::dijkstra_shortest_paths understands is given (visitor, distance_compare, distance_combine, distance_inf,
+ * distance_zero, vertex_index_map or color_map), all of the parameters are passed on to
+ * boost::dijkstra_shortest_paths, so that a visitor still sees every event. The queue that was used is returned.
+ */
+template<typename Graph, typename Param, typename Tag, typename Rest>
+dijkstra_queue integer_dijkstra_shortest_paths(const Graph &g,
+                                               const typename boost::graph_traits<Graph>::vertex_descriptor s,
+                                               const boost::bgl_named_params<Param, Tag, Rest> &params) {
+    const auto weight = boost::choose_const_pmap(boost::get_param(params, boost::edge_weight), g, boost::edge_weight);
+    using weight_type = typename boost::property_traits<std::decay_t<decltype(weight)>>::value_type;
+
+    if constexpr (!std::is_integral_v<weight_type> || detail::needs_boost_dijkstra<boost::bgl_named_params<Param, Tag, Rest>>) {
+        boost::dijkstra_shortest_paths(g, s, params);
+        return dijkstra_queue::heap;
+    } else {
+        weight_type max_weight = 0;
+        for (auto [eit, eend] = boost::edges(g); eit != eend; ++eit) {
+            const auto w = boost::get(weight, *eit);
+            if (w < 0) {
+                // Let Boost report the negative weight.
+                boost::dijkstra_shortest_paths(g, s, params);
+                return dijkstra_queue::heap;
+            }
+            max_weight = std::max(max_weight, w);
+        }
+
+        const auto predecessor = boost::choose_param(boost::get_param(params, boost::vertex_predecessor),
+                                                     boost::dummy_property_map());
+
+        // If no distance map was given, use a throwaway one.
+        std::vector<weight_type> distances;
+        auto distance_param = boost::get_param(params, boost::vertex_distance);
+        if constexpr (std::is_same_v<decltype(distance_param), boost::param_not_found>) {
+            distances.resize(boost::num_vertices(g));
+            const auto distance = boost::make_iterator_property_map(distances.begin(),
+                                                                    boost::get(boost::vertex_index, g));
+            return run_integer_dijkstra(g, s, max_weight, weight, predecessor, distance);
+        } else
+            return run_integer_dijkstra(g, s, max_weight, weight, predecessor, distance_param);
+    }
+}
@@ -0,0 +1,91 @@
+/**
+ * dijkstra_p2p.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Answering many single-pair shortest path queries on the same graph.
+ */
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/named_function_params.hpp>
+
+#include "graph_common.h"
+#include "dijkstra_p2p.h"
+
+int main() {
+    // The graph from dijkstra_paths: find the route from 0 to 4 both ways.
+    {
+        int constexpr v = 8;
+        std::array<int, v> weights{{1, 3, 2, 4, 3, 1, 2, 3}};
+        weighted_graph_t g = createCn_weighted(weights);
+
+        dijkstra_workspace<weighted_graph_t> workspace{g};
+        for (const bool bidirectional: {false, true}) {
+            const auto d = bidirectional ? workspace.bidirectional_shortest_path(0, 4) : workspace.shortest_path(0, 4);
+            std::cout << (bidirectional ? "Bidirectional" : "Unidirectional") << ": distance " << *d << ", path ";
+            const auto path = workspace.path();
+            std::copy(path.begin(), path.end(), vout);
+            std::cout << std::endl;
+        }
+    }
+
+    // Many random queries on a big graph, compared to a full Dijkstra per query.
+    {
+        constexpr std::size_t v = 200000;
+        constexpr std::size_t e = 600000;
+        constexpr std::size_t queries = 20;
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+        std::uniform_int_distribution<int> wdist(1, 100);
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        std::vector<int> weights;
+        for (std::size_t i = 0; i < e; ++i) {
+            edges.emplace_back(vdist(gen), vdist(gen));
+            weights.emplace_back(wdist(gen));
+        }
+        const weighted_graph_t g(edges.begin(), edges.end(), weights.begin(), v);
+
+        std::vector<std::pair<std::size_t, std::size_t>> pairs;
+        for (std::size_t i = 0; i < queries; ++i)
+            pairs.emplace_back(vdist(gen), vdist(gen));
+
+        // Times answering all of the queries with the given function, and returns the distances it found.
+        const auto run = [&](const char *name, auto &&query) {
+            std::vector<int> results;
+            const auto start = std::chrono::steady_clock::now();
+            for (const auto &[s, t]: pairs)
+                results.emplace_back(query(s, t));
+            const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << name << ": " << elapsed.count() / queries << " ms per query" << std::endl;
+            return results;
+        };
+
+        std::vector<int> distances(v);
+        const auto full = run("Full Dijkstra", [&](const std::size_t s, const std::size_t t) {
+            boost::dijkstra_shortest_paths(g, s, boost::distance_map(distances.data()));
+            return distances[t];
+        });
+
+        dijkstra_workspace<weighted_graph_t> workspace{g};
+        const auto unidirectional = run("Early exit", [&](const std::size_t s, const std::size_t t) {
+            return workspace.shortest_path(s, t).value_or(std::numeric_limits<int>::max());
+        });
+        const auto bidirectional = run("Bidirectional", [&](const std::size_t s, const std::size_t t) {
+            return workspace.bidirectional_shortest_path(s, t).value_or(std::numeric_limits<int>::max());
+        });
+
+        std::cout << "Same distances: " << std::boolalpha
+                  << (full == unidirectional && full == bidirectional) << std::endl;
+    }
+
+    return 0;
+}
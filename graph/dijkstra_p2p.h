@@ -0,0 +1,220 @@
+/**
+ * dijkstra_p2p.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Point-to-point shortest path queries.
+ *
+ * boost::dijkstra_shortest_paths always computes the shortest paths to every vertex, and starts by initializing a
+ * distance and predecessor for every vertex. When we only want the path from s to t, that's wasted work twice over:
+ *
+ * 1. The search can stop as soon as t is settled.
+ *
+ * 2. A query that only touches a few thousand vertices shouldn't pay O(V) to set up. A dijkstra_workspace keeps its
+ *    arrays between queries and remembers which entries each query touched, so only those are reset.
+ *
+ * It can also search from both ends at once (bidirectional Dijkstra): a search from s and one from t each grow a
+ * ball around their endpoint, and we stop once the two balls are guaranteed to have found the best meeting point.
+ * Two balls of radius d/2 usually cover far fewer vertices than one ball of radius d. The backward search follows
+ * out-edges, so bidirectional queries assume an undirected graph (or one storing every edge in both directions).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+/**
+ * Reusable state for point-to-point shortest path queries on a fixed graph. A workspace is not thread-safe: use
+ * one per thread.
+ */
+template<typename Graph,
+        typename WeightMap = typename boost::property_map<Graph, boost::edge_weight_t>::const_type>
+class dijkstra_workspace {
+public:
+    using vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
+    using distance_type = typename boost::property_traits<WeightMap>::value_type;
+
+    explicit dijkstra_workspace(const Graph &g) : dijkstra_workspace(g, boost::get(boost::edge_weight, g)) {}
+
+    dijkstra_workspace(const Graph &g, WeightMap weight)
+            : g_{g}, weight_{weight}, forward_{boost::num_vertices(g)}, backward_{boost::num_vertices(g)} {}
+
+    /** The length of the shortest path from s to t, or nothing if there is none. The search stops when t settles. **/
+    std::optional<distance_type> shortest_path(const vertex s, const vertex t) {
+        forward_.reset();
+        backward_.reset();
+        source_ = index(s);
+        target_ = meeting_ = index(t);
+
+        forward_.start(source_);
+        while (!forward_.done()) {
+            const auto u = forward_.pop();
+            if (u == target_)
+                return forward_.dist[target_];
+            relax(forward_, u, [](std::size_t, distance_type) {});
+        }
+        meeting_ = none;
+        return std::nullopt;
+    }
+
+    /** As shortest_path, but searching from s and t alternately. **/
+    std::optional<distance_type> bidirectional_shortest_path(const vertex s, const vertex t) {
+        forward_.reset();
+        backward_.reset();
+        source_ = index(s);
+        target_ = index(t);
+        meeting_ = none;
+
+        // best is the shortest s-t path found so far, through meeting_.
+        auto best = infinity;
+        forward_.start(source_);
+        backward_.start(target_);
+        if (source_ == target_) {
+            meeting_ = source_;
+            return distance_type{0};
+        }
+
+        // Once the two searches' next distances add up to more than the best path, no better path can exist.
+        while (!forward_.done() && !backward_.done() && forward_.top() + backward_.top() < best) {
+            auto &from = forward_.top() <= backward_.top() ? forward_ : backward_;
+            auto &other = &from == &forward_ ? backward_ : forward_;
+            const auto u = from.pop();
+            relax(from, u, [&](const std::size_t v, const distance_type dv) {
+                if (other.dist[v] != infinity && dv + other.dist[v] < best) {
+                    best = dv + other.dist[v];
+                    meeting_ = v;
+                }
+            });
+        }
+
+        if (meeting_ == none)
+            return std::nullopt;
+        return best;
+    }
+
+    /** The vertices on the path found by the last query, from s to t, or nothing if there was no path. **/
+    std::vector<vertex> path() const {
+        std::vector<vertex> result;
+        if (meeting_ == none)
+            return result;
+
+        for (auto v = meeting_; v != source_; v = forward_.pred[v])
+            result.push_back(boost::vertex(v, g_));
+        result.push_back(boost::vertex(source_, g_));
+        std::reverse(result.begin(), result.end());
+
+        for (auto v = meeting_; v != target_; ) {
+            v = backward_.pred[v];
+            result.push_back(boost::vertex(v, g_));
+        }
+        return result;
+    }
+
+    /** The number of vertices touched by the last query, i.e. the number of entries that will be reset. **/
+    std::size_t touched() const {
+        return forward_.touched.size() + backward_.touched.size();
+    }
+
+private:
+    static constexpr auto infinity = std::numeric_limits<distance_type>::max();
+    static constexpr auto none = std::numeric_limits<std::size_t>::max();
+
+    using entry = std::pair<distance_type, std::size_t>;
+
+    /** One direction of a search: tentative distances, predecessors and a heap. **/
+    struct search {
+        explicit search(const std::size_t n) : dist(n, infinity), pred(n, none) {}
+
+        std::vector<distance_type> dist;
+        std::vector<std::size_t> pred;
+        std::vector<std::size_t> touched;
+        std::vector<entry> heap;
+
+        void reset() {
+            for (const auto v: touched) {
+                dist[v] = infinity;
+                pred[v] = none;
+            }
+            touched.clear();
+            heap.clear();
+        }
+
+        void start(const std::size_t s) {
+            update(s, 0, s);
+        }
+
+        void update(const std::size_t v, const distance_type d, const std::size_t p) {
+            if (dist[v] == infinity)
+                touched.push_back(v);
+            dist[v] = d;
+            pred[v] = p;
+            heap.emplace_back(d, v);
+            std::push_heap(heap.begin(), heap.end(), std::greater<>{});
+        }
+
+        /**
+         * Drop stale heap entries, i.e. ones for vertices whose distance has improved since they were pushed.
+         * Distances only ever change by strictly improving, so each vertex has exactly one entry that isn't stale.
+         */
+        void skip_stale() {
+            while (!heap.empty() && heap.front().first != dist[heap.front().second]) {
+                std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+                heap.pop_back();
+            }
+        }
+
+        bool done() {
+            skip_stale();
+            return heap.empty();
+        }
+
+        distance_type top() {
+            skip_stale();
+            return heap.empty() ? infinity : heap.front().first;
+        }
+
+        std::size_t pop() {
+            skip_stale();
+            std::pop_heap(heap.begin(), heap.end(), std::greater<>{});
+            const auto v = heap.back().second;
+            heap.pop_back();
+            return v;
+        }
+    };
+
+    std::size_t index(const vertex v) const {
+        return boost::get(boost::vertex_index, g_, v);
+    }
+
+    /** Relax the out-edges of u in the given search, calling on_update(v, d) whenever v improves to d. **/
+    template<typename F>
+    void relax(search &s, const std::size_t u, F &&on_update) {
+        const auto du = s.dist[u];
+        for (auto [eit, eend] = boost::out_edges(boost::vertex(u, g_), g_); eit != eend; ++eit) {
+            const auto v = index(boost::target(*eit, g_));
+            const auto dv = du + boost::get(weight_, *eit);
+            if (dv < s.dist[v]) {
+                s.update(v, dv, u);
+                on_update(v, dv);
+            }
+        }
+    }
+
+    const Graph &g_;
+    WeightMap weight_;
+    search forward_;
+    search backward_;
+    std::size_t source_ = none;
+    std::size_t target_ = none;
+    std::size_t meeting_ = none;
+};
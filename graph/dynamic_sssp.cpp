@@ -0,0 +1,86 @@
+/**
+ * dynamic_sssp.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Keeping shortest paths up to date on a road-like grid whose weights keep changing.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/named_function_params.hpp>
+
+#include "graph_common.h"
+#include "dynamic_sssp.h"
+
+int main() {
+    // A W x H grid with random travel times, like a road network.
+    constexpr std::size_t W = 400;
+    constexpr std::size_t H = 400;
+    constexpr std::size_t n = W * H;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> wdist(10, 100);
+    weighted_graph_t g{n};
+    for (std::size_t y = 0; y < H; ++y)
+        for (std::size_t x = 0; x < W; ++x) {
+            if (x + 1 < W) boost::add_edge(y * W + x, y * W + x + 1, wdist(gen), g);
+            if (y + 1 < H) boost::add_edge(y * W + x, (y + 1) * W + x, wdist(gen), g);
+        }
+
+    dynamic_shortest_paths<weighted_graph_t> paths{g, 0};
+    using update = decltype(paths)::update;
+
+    // Each batch: traffic changes on 100 roads, one road closes and one new road opens.
+    std::uniform_int_distribution<std::size_t> xdist(0, W - 2);
+    std::uniform_int_distribution<std::size_t> ydist(0, H - 2);
+    std::vector<int> expected(n);
+    double repair_ms = 0, full_ms = 0;
+    bool same = true;
+    std::size_t touched = 0;
+    constexpr int batches = 20;
+    for (int b = 0; b < batches; ++b) {
+        std::vector<update> batch;
+        for (int i = 0; i < 100; ++i) {
+            const auto v = ydist(gen) * W + xdist(gen);
+            batch.emplace_back(update::changed(v, i % 2 ? v + 1 : v + W, wdist(gen)));
+        }
+        const auto closed = ydist(gen) * W + xdist(gen);
+        batch.emplace_back(update::removed(closed, closed + 1));
+        const auto opened = ydist(gen) * W + xdist(gen);
+        batch.emplace_back(update::inserted(opened, opened + W + 1, wdist(gen)));
+
+        auto start = std::chrono::steady_clock::now();
+        touched += paths.apply(batch);
+        repair_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        boost::dijkstra_shortest_paths(g, 0, boost::distance_map(
+                boost::make_iterator_property_map(expected.begin(), boost::get(boost::vertex_index, g))));
+        full_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        for (std::size_t v = 0; v < n; ++v)
+            same = same && paths.distance(v) == expected[v];
+    }
+
+    std::cout << batches << " batches of 102 updates on " << n << " vertices" << std::endl;
+    std::cout << "Repair: " << repair_ms / batches << " ms per batch, " << touched / batches
+              << " vertices touched per batch" << std::endl;
+    std::cout << "Dijkstra from scratch: " << full_ms / batches << " ms per batch" << std::endl;
+    std::cout << "Same distances: " << std::boolalpha << same << std::endl;
+
+    // Predecessors always lead back to the source along edges whose weights add up.
+    bool valid = true;
+    for (std::size_t v = 1; v < n; ++v) {
+        const auto p = paths.predecessor(v);
+        const auto [e, found] = boost::edge(p, v, g);
+        valid = valid && found && paths.distance(p) + boost::get(boost::edge_weight, g, e) == paths.distance(v);
+    }
+    std::cout << "Valid predecessors: " << valid << std::endl;
+
+    return 0;
+}
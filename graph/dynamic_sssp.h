@@ -0,0 +1,250 @@
+/**
+ * dynamic_sssp.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Single-source shortest paths that are kept up to date as the graph changes.
+ *
+ * When weights change after construction (as in play_props.cpp, where the carved edges get ep.weight += v1 % v2),
+ * the only way to refresh the output of boost::dijkstra_shortest_paths is to run it again. But a few changed
+ * edges usually only change the distances in a small region, and a dynamic_shortest_paths object repairs just that
+ * region, in the style of Ramalingam and Reps (1996):
+ *
+ * 1. An edge that gets cheaper, or is inserted, can only lower distances, and only starting from its endpoints:
+ *    they are relaxed across it and become the seeds of a Dijkstra search.
+ *
+ * 2. An edge that gets dearer, or is removed, only matters if it is in the shortest path tree. If it is, every
+ *    vertex in the subtree below it has lost its path. Those vertices are reset, given the best distance they can
+ *    get from a neighbour outside the subtree, and also added to the search.
+ *
+ * The search then runs exactly like Dijkstra, but only vertices whose distance actually changes are ever queued, so
+ * the work is proportional to the size of the affected region rather than the graph. Updates are applied in
+ * batches, so that one repair covers a whole batch.
+ *
+ * The graph must be undirected (so that out-edges are also in-edges), have non-negative weights, and keep its
+ * vertices in a vecS, so that vertex descriptors are indices.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+/** A change to one edge of a graph. **/
+template<typename Weight>
+struct edge_update {
+    enum kind_type { insert, remove, change };
+
+    kind_type kind;
+    std::size_t u;
+    std::size_t v;
+    Weight weight;
+
+    static edge_update inserted(const std::size_t u, const std::size_t v, const Weight weight) {
+        return {insert, u, v, weight};
+    }
+
+    static edge_update removed(const std::size_t u, const std::size_t v) { return {remove, u, v, Weight{}}; }
+
+    static edge_update changed(const std::size_t u, const std::size_t v, const Weight weight) {
+        return {change, u, v, weight};
+    }
+};
+
+/**
+ * The shortest paths from one source in a graph, kept up to date under batches of edge_updates. The graph is
+ * modified through apply, which both changes the graph and repairs the paths: changing the graph directly
+ * invalidates the paths, and requires a call to recompute.
+ */
+template<typename Graph,
+        typename WeightMap = typename boost::property_map<Graph, boost::edge_weight_t>::type>
+class dynamic_shortest_paths {
+    static_assert(boost::is_undirected_graph<Graph>::value, "dynamic_shortest_paths needs an undirected graph.");
+
+public:
+    using vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
+    using distance_type = typename boost::property_traits<WeightMap>::value_type;
+    using update = edge_update<distance_type>;
+
+    static constexpr auto infinity = std::numeric_limits<distance_type>::max();
+
+    dynamic_shortest_paths(Graph &g, const vertex s) : dynamic_shortest_paths(g, s, boost::get(boost::edge_weight, g)) {}
+
+    dynamic_shortest_paths(Graph &g, const vertex s, WeightMap weight) : g_{g}, weight_{weight}, source_{s} {
+        recompute();
+    }
+
+    /** Compute the paths from scratch. **/
+    void recompute() {
+        const std::size_t n = boost::num_vertices(g_);
+        dist_.assign(n, infinity);
+        pred_.resize(n);
+        for (std::size_t v = 0; v < n; ++v)
+            pred_[v] = v;
+        affected_.assign(n, 0);
+        heap_.clear();
+        touched_ = 0;
+        improve(source_, 0, source_);
+        search();
+    }
+
+    /**
+     * Apply a batch of updates to the graph, and repair the paths. Inserting an edge that already exists changes
+     * its weight, and removing one removes every edge between its ends. Returns the number of vertices whose
+     * distances were reset or improved along the way.
+     */
+    std::size_t apply(const std::vector<update> &batch) {
+        touched_ = 0;
+
+        // Change the graph, noting the tree edges that got worse, and the ends of the edges that got better.
+        std::vector<vertex> roots;
+        std::vector<vertex> better;
+        for (const auto &up: batch) {
+            // An edge to a vertex the graph doesn't have yet can't exist, and can't be looked up.
+            const bool known = std::max<std::size_t>(up.u, up.v) < boost::num_vertices(g_);
+            const auto [e, exists] = known ? boost::edge(up.u, up.v, g_)
+                                           : std::make_pair(typename boost::graph_traits<Graph>::edge_descriptor{}, false);
+            const auto old_weight = exists ? boost::get(weight_, e) : infinity;
+
+            if (up.kind == update::remove) {
+                if (exists)
+                    boost::remove_edge(up.u, up.v, g_);
+            } else if (exists)
+                boost::put(weight_, e, up.weight);
+            else
+                boost::put(weight_, boost::add_edge(up.u, up.v, g_).first, up.weight);
+
+            const auto new_weight = up.kind == update::remove ? infinity : up.weight;
+            if (new_weight < old_weight) {
+                better.emplace_back(up.u);
+                better.emplace_back(up.v);
+            } else if (new_weight > old_weight && exists) {
+                if (tree_edge(up.u, up.v))
+                    roots.emplace_back(up.v);
+                else if (tree_edge(up.v, up.u))
+                    roots.emplace_back(up.u);
+            }
+        }
+
+        // Inserted edges may have brought new vertices with them.
+        for (auto v = dist_.size(); v < boost::num_vertices(g_); ++v) {
+            dist_.emplace_back(infinity);
+            pred_.emplace_back(v);
+            affected_.emplace_back(0);
+        }
+
+        // Reset the subtrees hanging from the edges that got worse, and give each of their vertices the best
+        // distance it can get from outside.
+        const auto lost = subtrees(roots);
+        for (const auto v: lost) {
+            dist_[v] = infinity;
+            pred_[v] = v;
+        }
+        touched_ += lost.size();
+        for (const auto v: lost) {
+            for (auto [eit, eend] = boost::out_edges(v, g_); eit != eend; ++eit) {
+                const std::size_t x = boost::target(*eit, g_);
+                if (!affected_[x] && dist_[x] != infinity)
+                    improve(v, dist_[x] + boost::get(weight_, *eit), x);
+            }
+        }
+        for (const auto v: lost)
+            affected_[v] = 0;
+
+        // Relax the edges around the ones that got better. All of them are relaxed, with their current weights,
+        // since an edge may have changed more than once in the batch.
+        for (const auto u: better)
+            if (dist_[u] != infinity)
+                for (auto [eit, eend] = boost::out_edges(u, g_); eit != eend; ++eit)
+                    improve(boost::target(*eit, g_), dist_[u] + boost::get(weight_, *eit), u);
+
+        search();
+        return touched_;
+    }
+
+    vertex source() const { return source_; }
+
+    /** The distance to v, or infinity if it can't be reached. **/
+    distance_type distance(const vertex v) const { return dist_[v]; }
+
+    /** The predecessor of v on a shortest path. As with Boost, unreachable vertices are their own predecessors. **/
+    vertex predecessor(const vertex v) const { return pred_[v]; }
+
+    const std::vector<distance_type> &distances() const { return dist_; }
+    const std::vector<vertex> &predecessors() const { return pred_; }
+
+private:
+    using entry = std::pair<distance_type, vertex>;
+
+    /**
+     * Whether the edge u - v is the last edge of the shortest path to v. With parallel edges, this may be true of an
+     * edge that isn't, which only costs a little extra work.
+     */
+    bool tree_edge(const vertex u, const vertex v) const {
+        return u != v && pred_[v] == u;
+    }
+
+    /** Mark and return the roots and everything below them in the shortest path tree. **/
+    std::vector<vertex> subtrees(const std::vector<vertex> &roots) {
+        std::vector<vertex> result;
+        for (const auto r: roots)
+            if (!affected_[r]) {
+                affected_[r] = 1;
+                result.emplace_back(r);
+            }
+
+        // Children are found among the neighbours, since every tree edge is an edge of the graph.
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            const auto x = result[i];
+            for (auto [eit, eend] = boost::out_edges(x, g_); eit != eend; ++eit) {
+                const std::size_t w = boost::target(*eit, g_);
+                if (!affected_[w] && w != x && pred_[w] == x) {
+                    affected_[w] = 1;
+                    result.emplace_back(w);
+                }
+            }
+        }
+        return result;
+    }
+
+    void improve(const vertex v, const distance_type d, const vertex p) {
+        if (d < dist_[v]) {
+            dist_[v] = d;
+            pred_[v] = p;
+            heap_.emplace_back(d, v);
+            std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+            ++touched_;
+        }
+    }
+
+    /** Dijkstra from whatever is in the heap. Entries whose vertex has since improved are skipped. **/
+    void search() {
+        while (!heap_.empty()) {
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+            const auto [d, u] = heap_.back();
+            heap_.pop_back();
+            if (d != dist_[u])
+                continue;
+            for (auto [eit, eend] = boost::out_edges(u, g_); eit != eend; ++eit)
+                improve(boost::target(*eit, g_), d + boost::get(weight_, *eit), u);
+        }
+    }
+
+    Graph &g_;
+    WeightMap weight_;
+    vertex source_;
+    std::vector<distance_type> dist_;
+    std::vector<vertex> pred_;
+    std::vector<char> affected_;
+    std::vector<entry> heap_;
+    std::size_t touched_ = 0;
+};
@@ -0,0 +1,524 @@
+/**
+ * edge_reader.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Fast, parallel reading of graphs from text: plain edge lists and GraphViz DOT files.
+ *
+ * Reading "u v" pairs with operator>> goes through locales, sentries and a virtual call or two per character, and
+ * manages a few tens of megabytes a second. Here, the file is memory-mapped, cut into one chunk per thread at line
+ * boundaries, and each thread parses its chunk with std::from_chars, which does nothing but turn digits into
+ * numbers. Each thread writes its edges straight into its own chunk of the bulk builder's input (see
+ * sort_unique_chunks in graph_builder.h), already in the form the builder needs, so there is no intermediate
+ * vector of pairs to copy, and no single-threaded pass over the whole edge list.
+ *
+ * The formats understood are:
+ *
+ * 1. Edge lists: one edge "u v" per line, optionally followed by an integer weight. Blank lines and lines starting
+ *    with # or % are ignored.
+ *
+ * 2. DOT, as written by boost::write_graphviz: statements like "0;", "0 [label=a];", "0 -- 1;", "0 -> 1 -> 2;" and
+ *    "0--1 [weight=5];". Vertices must be numbered, possibly in quotes ("1" -- "2"), and a statement with a named
+ *    vertex is an error. A weight attribute is read if there is one, and everything else (graph, node and edge
+ *    attribute statements, braces, other attributes) is skipped. A statement may not span lines, but a line may
+ *    hold several statements separated by semicolons.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include "graph_common.h"
+#include "graph_builder.h"
+
+enum class edge_format {
+    detect,
+    edge_list,
+    dot
+};
+
+/** How the edges should be written, which depends on the graph they are for. **/
+enum class edge_form {
+    // Each undirected edge once, as (min, max), so that (u, v) and (v, u) are duplicates: for graph_t.
+    undirected,
+    // Each edge in both directions: for csr_graph_t.
+    symmetric,
+    // Each edge as it was read, e.g. for directed graphs.
+    as_read
+};
+
+struct edge_reader_params {
+    edge_format format = edge_format::detect;
+    edge_form form = edge_form::undirected;
+
+    // The number of threads. 0 means one per core. Small inputs use fewer, so each thread gets at least min_chunk.
+    unsigned threads = 0;
+    std::size_t min_chunk = 1 << 20;
+
+    // Whether to keep the weights. If not, they are skipped.
+    bool read_weights = false;
+};
+
+/** The edges read from some text, in one chunk per thread, and how long it took. **/
+struct parsed_edges {
+    std::vector<std::vector<edge_pair_t>> edges;
+
+    // weights[t][i] is the weight of edges[t][i], or 1 if it had none. Only filled in if read_weights was set.
+    std::vector<std::vector<int>> weights;
+
+    // One more than the largest vertex seen.
+    std::size_t num_vertices = 0;
+
+    std::size_t bytes = 0;
+    double seconds = 0;
+
+    std::size_t num_edges() const {
+        std::size_t result = 0;
+        for (const auto &chunk: edges)
+            result += chunk.size();
+        return result;
+    }
+
+    double megabytes_per_second() const { return seconds > 0 ? bytes / seconds / 1e6 : 0; }
+};
+
+namespace detail {
+    /** The state of one thread's parse of one chunk, [begin, end) of the whole text. **/
+    class edge_chunk_parser {
+    public:
+        edge_chunk_parser(const std::string_view whole, const std::size_t begin, const std::size_t end,
+                          const edge_form form, std::vector<edge_pair_t> &edges, std::vector<int> *weights)
+                : whole_{whole}, text_{whole.substr(begin, end - begin)}, offset_{begin}, form_{form}, edges_{edges},
+                  weights_{weights} {}
+
+        std::size_t num_vertices() const { return num_vertices_; }
+
+        void parse_edge_list() {
+            while (pos_ < text_.size()) {
+                skip_blanks();
+                if (at_line_end() || text_[pos_] == '#' || text_[pos_] == '%') {
+                    skip_line();
+                    continue;
+                }
+                const auto u = number("vertex");
+                skip_blanks();
+                const auto v = number("vertex");
+                skip_blanks();
+                int w = 1;
+                if (!at_line_end()) {
+                    w = weight(signed_number("weight"));
+                    skip_blanks();
+                }
+                if (!at_line_end())
+                    fail("expected the end of the line");
+                add(u, v, w);
+                skip_line();
+            }
+        }
+
+        void parse_dot() {
+            while (pos_ < text_.size()) {
+                skip_blanks();
+                const auto c = pos_ < text_.size() ? text_[pos_] : '\n';
+                if (c == '\n' || c == ';' || c == '{' || c == '}') {
+                    ++pos_;
+                } else if ((c >= '0' && c <= '9') || c == '"') {
+                    dot_statement();
+                } else if (c == '/' && pos_ + 1 < text_.size() && text_[pos_ + 1] == '/') {
+                    skip_line();
+                } else {
+                    dot_keyword_statement();
+                }
+            }
+        }
+
+    private:
+        /**
+         * A statement that doesn't start with a vertex: graph, digraph, strict and subgraph headers, graph, node and
+         * edge attribute statements, and graph attributes like rankdir=LR are skipped. Anything else starts with a
+         * vertex that isn't numbered, which can't be read.
+         */
+        void dot_keyword_statement() {
+            const auto start = pos_;
+            while (pos_ < text_.size() && (std::isalnum(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '_'))
+                ++pos_;
+            std::string word{text_.substr(start, pos_ - start)};
+            for (auto &c: word)
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            skip_blanks();
+
+            if (word.empty() || word == "graph" || word == "digraph" || word == "strict" || word == "subgraph"
+                || word == "node" || word == "edge" || (pos_ < text_.size() && text_[pos_] == '=')) {
+                skip_statement();
+                return;
+            }
+            pos_ = start;
+            fail("vertices must be numbered, not " + std::string{text_.substr(start, word.size())});
+        }
+
+        /** A vertex of a DOT statement: a number, possibly in quotes, like "1". **/
+        std::size_t dot_vertex() {
+            if (pos_ >= text_.size() || text_[pos_] != '"')
+                return number("vertex");
+            const auto start = pos_;
+            const auto id = dot_id("vertex");
+            std::size_t value = 0;
+            const auto [end, ec] = std::from_chars(id.data(), id.data() + id.size(), value);
+            if (ec != std::errc{} || end != id.data() + id.size()) {
+                pos_ = start;
+                fail("vertices must be numbered, not \"" + std::string{id} + "\"");
+            }
+            return value;
+        }
+
+        /** A node statement "a [...]" or an edge statement "a -- b -- c [...]". **/
+        void dot_statement() {
+            auto &chain = chain_;
+            chain.assign(1, dot_vertex());
+            while (true) {
+                skip_blanks();
+                if (pos_ + 1 < text_.size() && text_[pos_] == '-' && (text_[pos_ + 1] == '-' || text_[pos_ + 1] == '>')) {
+                    pos_ += 2;
+                    skip_blanks();
+                    chain.emplace_back(dot_vertex());
+                } else
+                    break;
+            }
+
+            int w = 1;
+            if (pos_ < text_.size() && text_[pos_] == '[')
+                w = dot_attributes();
+            skip_blanks();
+            if (!at_line_end() && text_[pos_] != ';' && text_[pos_] != '}')
+                fail("expected the end of the statement");
+
+            if (chain.size() == 1)
+                num_vertices_ = std::max(num_vertices_, chain.front() + 1);
+            for (std::size_t i = 1; i < chain.size(); ++i)
+                add(chain[i - 1], chain[i], w);
+        }
+
+        /**
+         * Parse an attribute list of key=value pairs, separated by commas, semicolons or blanks, returning the value
+         * of its weight attribute, or 1. Only a key of exactly "weight" counts, so label="weight 3" doesn't.
+         */
+        int dot_attributes() {
+            ++pos_;
+            int w = 1;
+            while (true) {
+                while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == ','
+                                               || text_[pos_] == ';'))
+                    ++pos_;
+                if (at_line_end())
+                    fail("unterminated attribute list");
+                if (text_[pos_] == ']') {
+                    ++pos_;
+                    return w;
+                }
+
+                const auto key = dot_id("attribute name");
+                skip_blanks();
+                if (pos_ >= text_.size() || text_[pos_] != '=')
+                    fail("expected = after attribute " + std::string{key});
+                ++pos_;
+                skip_blanks();
+                const auto value = dot_id("attribute value");
+                if (key == "weight") {
+                    long long parsed = 0;
+                    const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+                    if (ec != std::errc{} || end != value.data() + value.size())
+                        fail("bad weight attribute");
+                    w = weight(parsed);
+                }
+            }
+        }
+
+        /** A DOT ID: a double-quoted string (returned without the quotes), or a run of other characters. **/
+        std::string_view dot_id(const char *what) {
+            if (pos_ < text_.size() && text_[pos_] == '"') {
+                const auto start = ++pos_;
+                while (pos_ < text_.size() && text_[pos_] != '"' && text_[pos_] != '\n')
+                    pos_ += text_[pos_] == '\\' && pos_ + 1 < text_.size() && text_[pos_ + 1] != '\n' ? 2 : 1;
+                if (pos_ >= text_.size() || text_[pos_] != '"')
+                    fail("unterminated string");
+                return text_.substr(start, pos_++ - start);
+            }
+            const auto start = pos_;
+            while (pos_ < text_.size() && std::string_view{" \t\r\n,;=[]"}.find(text_[pos_]) == std::string_view::npos)
+                ++pos_;
+            if (pos_ == start)
+                fail(std::string{"expected an "} + what);
+            return text_.substr(start, pos_ - start);
+        }
+
+        void add(const std::size_t u, const std::size_t v, const int w) {
+            num_vertices_ = std::max(num_vertices_, std::max(u, v) + 1);
+            switch (form_) {
+                case edge_form::undirected:
+                    edges_.emplace_back(std::min(u, v), std::max(u, v));
+                    break;
+                case edge_form::symmetric:
+                    edges_.emplace_back(u, v);
+                    edges_.emplace_back(v, u);
+                    break;
+                case edge_form::as_read:
+                    edges_.emplace_back(u, v);
+                    break;
+            }
+            if (weights_)
+                weights_->resize(edges_.size(), w);
+        }
+
+        std::size_t number(const char *what) {
+            std::size_t value = 0;
+            const auto [end, ec] = std::from_chars(text_.data() + pos_, text_.data() + text_.size(), value);
+            if (ec != std::errc{})
+                fail(std::string{"expected a "} + what);
+            pos_ = end - text_.data();
+            return value;
+        }
+
+        long long signed_number(const char *what) {
+            long long value = 0;
+            const auto [end, ec] = std::from_chars(text_.data() + pos_, text_.data() + text_.size(), value);
+            if (ec != std::errc{})
+                fail(std::string{"expected a "} + what);
+            pos_ = end - text_.data();
+            return value;
+        }
+
+        /** A weight as stored, which must fit in an int. **/
+        int weight(const long long w) const {
+            try {
+                return checked_weight<int>(w);
+            } catch (const std::range_error &ex) {
+                fail(ex.what());
+            }
+        }
+
+        bool at_line_end() const { return pos_ >= text_.size() || text_[pos_] == '\n' || text_[pos_] == '\r'; }
+
+        void skip_blanks() {
+            while (pos_ < text_.size() && (text_[pos_] == ' ' || text_[pos_] == '\t'))
+                ++pos_;
+        }
+
+        void skip_line() {
+            const auto end = text_.find('\n', pos_);
+            pos_ = end == std::string_view::npos ? text_.size() : end + 1;
+        }
+
+        void skip_statement() {
+            while (pos_ < text_.size() && text_[pos_] != '\n' && text_[pos_] != ';' && text_[pos_] != '{') {
+                if (text_[pos_] == '[') {
+                    const auto close = text_.find(']', pos_);
+                    pos_ = close == std::string_view::npos ? text_.size() : close;
+                }
+                ++pos_;
+            }
+        }
+
+        /** Throw, naming the line and byte. Counting the lines up to here is slow, but only done once. **/
+        [[noreturn]] void fail(const std::string &message) const {
+            const auto at = offset_ + pos_;
+            const auto line = 1 + std::count(whole_.begin(), whole_.begin() + std::min(at, whole_.size()), '\n');
+            throw std::runtime_error("line " + std::to_string(line) + ", byte " + std::to_string(at) + ": " + message);
+        }
+
+        std::string_view whole_;
+        std::string_view text_;
+        std::size_t offset_;
+        edge_form form_;
+        std::vector<edge_pair_t> &edges_;
+        std::vector<int> *weights_;
+        std::size_t pos_ = 0;
+        std::size_t num_vertices_ = 0;
+
+        // The vertices of the current DOT edge statement, kept to save allocating for every statement.
+        std::vector<std::size_t> chain_;
+    };
+
+    /** Guess the format from the first statement: DOT files start with graph, digraph or strict. **/
+    inline edge_format detect_edge_format(const std::string_view text) {
+        const auto start = text.find_first_not_of(" \t\r\n");
+        if (start == std::string_view::npos)
+            return edge_format::edge_list;
+        const auto first = text.substr(start, 7);
+        return first.substr(0, 5) == "graph" || first == "digraph" || first.substr(0, 6) == "strict"
+               ? edge_format::dot : edge_format::edge_list;
+    }
+}
+
+/**
+ * Parse edges from text in memory, using several threads. Throws std::runtime_error, naming the line and byte
+ * offset, if the text can't be parsed, or a weight doesn't fit in an int.
+ */
+parsed_edges read_edges(const std::string_view text, const edge_reader_params params = {}) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto format = params.format == edge_format::detect ? detail::detect_edge_format(text) : params.format;
+    const unsigned threads = std::max<std::size_t>(1, std::min<std::size_t>(
+            params.threads ? params.threads : default_threads(), text.size() / std::max<std::size_t>(1, params.min_chunk)));
+
+    // Chunk t holds the lines that start in [n * t / threads, n * (t + 1) / threads).
+    const auto line_start = [&](const std::size_t at) -> std::size_t {
+        if (at == 0 || at >= text.size())
+            return std::min(at, text.size());
+        const auto newline = text.find('\n', at - 1);
+        return newline == std::string_view::npos ? text.size() : newline + 1;
+    };
+    std::vector<std::size_t> bounds(threads + 1);
+    for (unsigned t = 0; t <= threads; ++t)
+        bounds[t] = line_start(text.size() * t / threads);
+
+    parsed_edges result;
+    result.edges.resize(threads);
+    if (params.read_weights)
+        result.weights.resize(threads);
+    std::vector<std::size_t> num_vertices(threads, 0);
+    std::vector<std::exception_ptr> errors(threads);
+
+    const auto worker = [&](const unsigned t) {
+        try {
+            detail::edge_chunk_parser parser{text, bounds[t], bounds[t + 1], params.form, result.edges[t],
+                                             params.read_weights ? &result.weights[t] : nullptr};
+            if (format == edge_format::dot)
+                parser.parse_dot();
+            else
+                parser.parse_edge_list();
+            num_vertices[t] = parser.num_vertices();
+        } catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (auto &w: workers)
+        w.join();
+    for (const auto &error: errors)
+        if (error)
+            std::rethrow_exception(error);
+
+    result.num_vertices = *std::max_element(num_vertices.begin(), num_vertices.end());
+    result.bytes = text.size();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+/** Parse edges from a file, which is memory-mapped rather than read. **/
+parsed_edges read_edge_file(const std::string &filename, const edge_reader_params params = {}) {
+    if (std::filesystem::file_size(filename) == 0)
+        return read_edges(std::string_view{}, params);
+
+    const boost::interprocess::file_mapping file{filename.c_str(), boost::interprocess::read_only};
+    const boost::interprocess::mapped_region region{file, boost::interprocess::read_only};
+    try {
+        return read_edges({static_cast<const char *>(region.get_address()), region.get_size()}, params);
+    } catch (const std::runtime_error &ex) {
+        throw std::runtime_error(filename + ": " + ex.what());
+    }
+}
+
+/**
+ * Build a graph_t from edges read in edge_form::undirected. Each thread's chunk goes straight to the bulk builder,
+ * so the edges are never gathered into one vector before being sorted.
+ */
+graph_t build_graph(parsed_edges parsed) {
+    const auto n = parsed.num_vertices;
+    const auto edges = sort_unique_chunks(std::move(parsed.edges));
+    return graph_t(edges.begin(), edges.end(), n);
+}
+
+/** Build a csr_graph_t (or another unweighted CSR graph type) from edges read in edge_form::symmetric. **/
+template<typename Graph = csr_graph_t>
+Graph build_csr(parsed_edges parsed) {
+    const auto n = parsed.num_vertices;
+    const auto arcs = sort_unique_chunks(std::move(parsed.edges));
+    check_csr_size<Graph>(n, arcs.size());
+    return Graph(boost::edges_are_sorted, arcs.begin(), arcs.end(), n);
+}
+
+namespace detail {
+    /** Iterates over the elements of a vector of chunks as if they were one vector, skipping empty chunks. **/
+    template<typename T>
+    class joined_iterator : public boost::iterator_facade<joined_iterator<T>, const T, std::forward_iterator_tag> {
+    public:
+        joined_iterator() = default;
+        joined_iterator(const std::vector<std::vector<T>> &chunks, const std::size_t chunk)
+                : chunks_{&chunks}, chunk_{chunk} { skip(); }
+
+    private:
+        friend class boost::iterator_core_access;
+
+        const T &dereference() const { return (*chunks_)[chunk_][i_]; }
+        bool equal(const joined_iterator &other) const { return chunk_ == other.chunk_ && i_ == other.i_; }
+
+        void increment() {
+            ++i_;
+            skip();
+        }
+
+        void skip() {
+            while (chunk_ < chunks_->size() && i_ == (*chunks_)[chunk_].size()) {
+                ++chunk_;
+                i_ = 0;
+            }
+        }
+
+        const std::vector<std::vector<T>> *chunks_ = nullptr;
+        std::size_t chunk_ = 0;
+        std::size_t i_ = 0;
+    };
+
+    template<typename T>
+    std::pair<joined_iterator<T>, joined_iterator<T>> joined(const std::vector<std::vector<T>> &chunks) {
+        return {joined_iterator<T>{chunks, 0}, joined_iterator<T>{chunks, chunks.size()}};
+    }
+}
+
+/**
+ * Build a weighted_csr_graph_t from edges read in edge_form::symmetric with read_weights set. As with
+ * make_weighted_csr, repeated edges are kept. The CSR constructor reads the threads' chunks in place, through an
+ * iterator that walks them one after the other, so the arcs and weights are never gathered into one vector.
+ * Throws std::invalid_argument if the edges weren't read with their weights.
+ */
+weighted_csr_graph_t build_weighted_csr(const parsed_edges &parsed) {
+    bool weighted = parsed.weights.size() == parsed.edges.size();
+    for (std::size_t t = 0; weighted && t < parsed.edges.size(); ++t)
+        weighted = parsed.weights[t].size() == parsed.edges[t].size();
+    if (!weighted)
+        throw std::invalid_argument("build_weighted_csr needs edges read with read_weights set");
+
+    const auto [arcs_begin, arcs_end] = detail::joined(parsed.edges);
+    return weighted_csr_graph_t(boost::edges_are_unsorted_multi_pass, arcs_begin, arcs_end,
+                                detail::joined(parsed.weights).first, parsed.num_vertices);
+}
+
+/** Read a graph_t from an edge list or DOT file. **/
+graph_t read_graph(const std::string &filename, const unsigned threads = 0) {
+    return build_graph(read_edge_file(filename, {edge_format::detect, edge_form::undirected, threads}));
+}
+
+/** Read a csr_graph_t from an edge list or DOT file. **/
+csr_graph_t read_csr(const std::string &filename, const unsigned threads = 0) {
+    return build_csr(read_edge_file(filename, {edge_format::detect, edge_form::symmetric, threads}));
+}
@@ -0,0 +1,122 @@
+/**
+ * generators.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Synthetic graphs of any size, as edge lists, for benchmarking.
+ *
+ * The createCn_* graphs in graph_common.h are tiny cycles, which is fine for seeing how an algorithm works, but
+ * says nothing about how it scales. These generators cover the shapes that matter for performance:
+ *
+ * 1. R-MAT (Chakrabarti, Zhan and Faloutsos, 2004): the Graph500 Kronecker-style generator. A few hubs with huge
+ *    degree, a long tail of small ones, and a small diameter, like social and web graphs.
+ *
+ * 2. Grids and tori: every vertex has degree 4 and the diameter is huge, like meshes and road networks.
+ *
+ * 3. Random geometric graphs: points scattered in the unit square, joined when they are close. Good locality and
+ *    a moderate diameter.
+ *
+ * 4. Cycles: the createCn_* shape, at scale. The worst case for level-synchronous algorithms.
+ *
+ * Each generator returns the edge list and the number of vertices, ready for build_graph, build_csr or make_csr.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/rmat_graph_generator.hpp>
+
+#include "graph_common.h"
+#include "graph_builder.h"
+
+/** An edge list, and how many vertices it is over. **/
+struct generated_graph {
+    std::string name;
+    std::size_t num_vertices = 0;
+    std::vector<edge_pair_t> edges;
+};
+
+/**
+ * An R-MAT graph on 2^scale vertices with edge_factor * 2^scale edges, with the Graph500 probabilities by default.
+ * The vertices are randomly permuted, so that the hubs are not all at the front.
+ */
+generated_graph rmat_graph(const unsigned scale, const std::size_t edge_factor = 16,
+                           const double a = 0.57, const double b = 0.19, const double c = 0.19,
+                           const unsigned seed = 0) {
+    using rmat_iterator = boost::rmat_iterator<std::mt19937, graph_t>;
+    std::mt19937 gen(seed);
+    const std::size_t n = std::size_t{1} << scale;
+    const auto m = edge_factor * n;
+
+    generated_graph result{"rmat-" + std::to_string(scale), n, {}};
+    result.edges.reserve(m);
+    for (rmat_iterator it{gen, n, m, a, b, c, 1 - a - b - c}, end; it != end; ++it)
+        result.edges.emplace_back(it->first, it->second);
+    return result;
+}
+
+/** A W x H grid with 4 neighbours per vertex, wrapping around into a torus if wrap is set. **/
+generated_graph grid_graph(const std::size_t width, const std::size_t height, const bool wrap = false) {
+    generated_graph result{(wrap ? "torus-" : "grid-") + std::to_string(width) + "x" + std::to_string(height),
+                           width * height, {}};
+    result.edges.reserve(2 * width * height);
+    for (std::size_t y = 0; y < height; ++y)
+        for (std::size_t x = 0; x < width; ++x) {
+            const auto v = y * width + x;
+            if (x + 1 < width || wrap)
+                result.edges.emplace_back(v, y * width + (x + 1) % width);
+            if (y + 1 < height || wrap)
+                result.edges.emplace_back(v, (y + 1) % height * width + x);
+        }
+    return result;
+}
+
+/**
+ * n random points in the unit square, with an edge between every two points less than radius apart. The expected
+ * degree is about n * pi * radius^2. The points are bucketed into cells of side radius, so only neighbouring cells
+ * are compared.
+ */
+generated_graph geometric_graph(const std::size_t n, const double radius, const unsigned seed = 0) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> coordinate(0, 1);
+    std::vector<std::pair<double, double>> points(n);
+    for (auto &p: points)
+        p = {coordinate(gen), coordinate(gen)};
+
+    const auto cells = std::max<std::size_t>(1, static_cast<std::size_t>(1 / radius));
+    const auto cell_of = [cells](const double c) { return std::min(cells - 1, static_cast<std::size_t>(c * cells)); };
+    std::vector<std::vector<std::size_t>> grid(cells * cells);
+    for (std::size_t v = 0; v < n; ++v)
+        grid[cell_of(points[v].second) * cells + cell_of(points[v].first)].emplace_back(v);
+
+    generated_graph result{"geometric-" + std::to_string(n), n, {}};
+    for (std::size_t v = 0; v < n; ++v) {
+        const auto cx = cell_of(points[v].first);
+        const auto cy = cell_of(points[v].second);
+        for (auto y = cy ? cy - 1 : 0; y <= std::min(cells - 1, cy + 1); ++y)
+            for (auto x = cx ? cx - 1 : 0; x <= std::min(cells - 1, cx + 1); ++x)
+                for (const auto w: grid[y * cells + x]) {
+                    const auto dx = points[v].first - points[w].first;
+                    const auto dy = points[v].second - points[w].second;
+                    if (v < w && dx * dx + dy * dy < radius * radius)
+                        result.edges.emplace_back(v, w);
+                }
+    }
+    return result;
+}
+
+/** The cycle C_n, as in createCn_ep. **/
+generated_graph cycle_graph(const std::size_t n) {
+    generated_graph result{"cycle-" + std::to_string(n), n, {}};
+    result.edges.reserve(n);
+    for (std::size_t v = 0; v < n; ++v)
+        result.edges.emplace_back(v, (v + 1) % n);
+    return result;
+}
@@ -0,0 +1,161 @@
+/**
+ * graph_builder.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Bulk construction of graphs from large edge lists.
+ *
+ * Building a graph_t by calling add_edge once per edge means one std::set insert (and duplicate check) per edge.
+ * For big inputs, it's much faster to do all of the work up front on a flat array: sort the edges, throw away
+ * the duplicates, and then hand the clean list to the graph in one go. The sorting and deduplicating is split
+ * across threads.
+ *
+ * That only pays off if the graph doesn't redo the work. A graph_t still inserts every edge into a std::set, so
+ * build_graph saves it little; the real gains are for graphs that can take the edges as they come: vec_graph_t,
+ * whose out-edges are vectors, and the CSR graphs from build_csr.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+
+#include "graph_common.h"
+
+using edge_pair_t = std::pair<std::size_t, std::size_t>;
+
+/** The number of threads to use if none is specified: one per core, and at least one. **/
+unsigned default_threads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * Sort and deduplicate a vector that has already been cut into chunks, returning one sorted vector with no
+ * duplicates. Each chunk is sorted and deduplicated on its own thread, and then the chunks are merged pairwise
+ * (again in parallel), dropping duplicates that straddle two chunks, until only one is left.
+ */
+template<typename T>
+std::vector<T> sort_unique_chunks(std::vector<std::vector<T>> chunks) {
+    if (chunks.empty())
+        return {};
+
+    {
+        std::vector<std::thread> workers;
+        for (auto &chunk: chunks)
+            workers.emplace_back([&chunk] {
+                std::sort(chunk.begin(), chunk.end());
+                chunk.erase(std::unique(chunk.begin(), chunk.end()), chunk.end());
+            });
+        for (auto &w: workers)
+            w.join();
+    }
+
+    // Merge neighbouring chunks in parallel rounds until there is only one left.
+    while (chunks.size() > 1) {
+        std::vector<std::vector<T>> merged((chunks.size() + 1) / 2);
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < merged.size(); ++i)
+            workers.emplace_back([&, i] {
+                if (2 * i + 1 == chunks.size()) {
+                    merged[i] = std::move(chunks[2 * i]);
+                    return;
+                }
+                auto &a = chunks[2 * i];
+                auto &b = chunks[2 * i + 1];
+                auto &out = merged[i];
+                out.reserve(a.size() + b.size());
+                std::merge(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+                out.erase(std::unique(out.begin(), out.end()), out.end());
+                a = std::vector<T>{};
+                b = std::vector<T>{};
+            });
+        for (auto &w: workers)
+            w.join();
+        chunks = std::move(merged);
+    }
+
+    return std::move(chunks.front());
+}
+
+/**
+ * Sort a vector and remove its duplicates using several threads: the vector is cut into one chunk per thread,
+ * which are then handled by sort_unique_chunks.
+ */
+template<typename T>
+std::vector<T> parallel_sort_unique(std::vector<T> values, unsigned threads = default_threads()) {
+    const auto n = values.size();
+    threads = std::max(1u, std::min<unsigned>(threads, n / 2 + 1));
+    if (threads == 1) {
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        return values;
+    }
+
+    std::vector<std::vector<T>> chunks(threads);
+    for (unsigned t = 0; t < threads; ++t)
+        chunks[t].assign(std::make_move_iterator(values.begin() + n * t / threads),
+                         std::make_move_iterator(values.begin() + n * (t + 1) / threads));
+    values.clear();
+    values.shrink_to_fit();
+    return sort_unique_chunks(std::move(chunks));
+}
+
+/**
+ * Copy an edge range into a flat vector, with each undirected edge {u,v} written as (min, max) so that (u,v) and
+ * (v,u) become duplicates of one another. If symmetric is true, both (u,v) and (v,u) are emitted instead, which
+ * is what the CSR graph needs to represent an undirected graph.
+ */
+template<typename EdgeIterator>
+std::vector<edge_pair_t> collect_edges(EdgeIterator begin, EdgeIterator end, const bool symmetric) {
+    std::vector<edge_pair_t> edges;
+    if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+            typename std::iterator_traits<EdgeIterator>::iterator_category>)
+        edges.reserve((symmetric ? 2 : 1) * std::distance(begin, end));
+
+    for (; begin != end; ++begin) {
+        const std::size_t u = begin->first;
+        const std::size_t v = begin->second;
+        if (symmetric) {
+            edges.emplace_back(u, v);
+            edges.emplace_back(v, u);
+        } else
+            edges.emplace_back(std::min(u, v), std::max(u, v));
+    }
+    return edges;
+}
+
+/**
+ * Bulk-build an adjacency list with n vertices from a range of (possibly repeated) undirected edges, e.g.
+ *
+ *     const auto g = build_graph<vec_graph_t>(edges.begin(), edges.end(), n);
+ *
+ * Because the edges are already unique when they reach the graph, a vec_graph_t gets no parallel edges, and each
+ * edge is a push_back. A graph_t (the default) still does one set insert per edge, none of which will fail, so
+ * only the duplicate handling is saved.
+ */
+template<typename Graph = graph_t, typename EdgeIterator>
+Graph build_graph(EdgeIterator begin, EdgeIterator end, const std::size_t n, const unsigned threads = default_threads()) {
+    const auto edges = parallel_sort_unique(collect_edges(begin, end, false), threads);
+    return Graph(edges.begin(), edges.end(), n);
+}
+
+/**
+ * Bulk-build a csr_graph_t (or another unweighted CSR graph type, such as compact_csr_graph_t) with n vertices from
+ * a range of (possibly repeated) undirected edges. Unlike make_csr, duplicates are removed, and since the arcs
+ * arrive sorted by source, the CSR graph can be filled in a single pass with the edges_are_sorted constructor.
+ * Throws std::range_error if the graph's types are too narrow (see check_csr_size).
+ */
+template<typename Graph = csr_graph_t, typename EdgeIterator>
+Graph build_csr(EdgeIterator begin, EdgeIterator end, const std::size_t n, const unsigned threads = default_threads()) {
+    const auto arcs = parallel_sort_unique(collect_edges(begin, end, true), threads);
+    check_csr_size<Graph>(n, arcs.size());
+    return Graph(boost::edges_are_sorted, arcs.begin(), arcs.end(), n);
+}
@@ -7,10 +7,17 @@
 #pragma once
 
 #include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 #include <boost/log/trivial.hpp>
 #include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
 
 // See: https://gist.github.com/daviddoria/3a95428c85057c2b404ef9193083a6c3
 /**
@@ -29,6 +36,11 @@ using graph_t = boost::adjacency_list<boost::setS, boost::vecS, boost::undirecte
 using weighted_graph_t = boost::adjacency_list<boost::setS, boost::vecS, boost::undirectedS,
         boost::no_property, boost::property<boost::edge_weight_t, int>>;
 
+// graph_t with its out-edges in vectors instead of sets. Adding an edge is a push_back rather than a set insert, so
+// it's much faster to fill, but nothing stops parallel edges: give it edges that are already unique, as build_graph
+// in graph_builder.h does.
+using vec_graph_t = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS>;
+
 // Here is an unused definition of a directed graph with coloured vertices and edges, and weighted edges.
 // We wrap the edge colouring and weighting in a pair.
 // Things like edge_weight_t and vertex_color_t are tags provided by Boost as they are frequently used.
@@ -36,6 +48,37 @@ using weighted_graph_t = boost::adjacency_list<boost::setS, boost::vecS, boost::
 using graph_coloured_vertices_and_edges_weighted_edges = boost::adjacency_list<boost::setS, boost::vecS, boost::directedS,
         boost::property<boost::vertex_color_t, int>, std::pair<boost::property<boost::edge_color_t, int>, boost::property<boost::edge_weight_t, int>>>;
 
+// A frozen alternative to graph_t using compressed sparse row (CSR) storage.
+// Instead of one std::set per vertex, all out-edges live in two contiguous arrays: a per-vertex offset array
+// and a target array. It can't be modified after construction, but it uses far less memory and traversals
+// just walk consecutive memory.
+// Boost's CSR graph only supports directedS (and bidirectionalS), so to represent an undirected graph we store
+// every edge in both directions: see make_csr below.
+using csr_graph_t = boost::compressed_sparse_row_graph<boost::directedS>;
+
+// The CSR equivalent of weighted_graph_t. Weights are stored in a third contiguous array parallel to the targets.
+using weighted_csr_graph_t = boost::compressed_sparse_row_graph<boost::directedS,
+        boost::no_property, boost::property<boost::edge_weight_t, int>>;
+
+// CSR graphs with configurable widths. Boost's CSR graph lets us choose the integer type of the vertices (which is
+// also the type of each entry of the target array) and of the edge indices (the type of the offset array).
+// With fewer than 4 billion vertices and edges, 32 bits are plenty, and every target, offset, vertex descriptor
+// and predecessor entry is half the size. Weights can be narrowed the same way, e.g. float for double, or uint16_t
+// for small integer weights.
+// NOTE: Dijkstra keeps its distances in the weight type unless it is given a distance_map, so with narrow integer
+// weights, pass a distance_map of a wider type, or long paths will overflow.
+template<typename Vertex = std::size_t, typename EdgeIndex = Vertex>
+using csr_graph_of = boost::compressed_sparse_row_graph<boost::directedS,
+        boost::no_property, boost::no_property, boost::no_property, Vertex, EdgeIndex>;
+
+template<typename Weight, typename Vertex = std::size_t, typename EdgeIndex = Vertex>
+using weighted_csr_graph_of = boost::compressed_sparse_row_graph<boost::directedS,
+        boost::no_property, boost::property<boost::edge_weight_t, Weight>, boost::no_property, Vertex, EdgeIndex>;
+
+// 32-bit vertices and edge indices, with float weights.
+using compact_csr_graph_t = csr_graph_of<std::uint32_t>;
+using compact_weighted_csr_graph_t = weighted_csr_graph_of<float, std::uint32_t>;
+
 using vertex_t = graph_t::vertex_descriptor;
 using edge_t   = graph_t::edge_descriptor;
 
@@ -97,4 +140,108 @@ weighted_graph_t createCn_weighted(std::array<int, N> &weights) {
         edges[i] = std::make_pair(i, (i+3) % N);
 
     return weighted_graph_t(edges.begin(), edges.end(), weights.begin(), N);
-}
\ No newline at end of file
+}
+
+/**
+ * Check that a CSR graph of type Graph can hold n vertices and the given number of arcs: the vertex type must
+ * number every vertex and still leave its largest value for null_vertex, and the edge index type must number every
+ * arc. Throws std::range_error otherwise, rather than letting narrow types silently wrap around.
+ */
+template<typename Graph>
+void check_csr_size(const std::size_t n, const std::size_t arcs) {
+    using vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
+    using edge_index = typename boost::graph_traits<Graph>::edges_size_type;
+    if (n >= static_cast<std::uintmax_t>(std::numeric_limits<vertex>::max()))
+        throw std::range_error(std::to_string(n) + " vertices don't fit in the graph's vertex type");
+    if (arcs > static_cast<std::uintmax_t>(std::numeric_limits<edge_index>::max()))
+        throw std::range_error(std::to_string(arcs) + " arcs don't fit in the graph's edge index type");
+}
+
+/**
+ * Convert a weight to a narrower weight type, throwing std::range_error if it doesn't fit: integer weights must be
+ * in range (and whole, if they come from floating point), and floating point weights in range (infinities carry
+ * over). Floating point weights may still be rounded, e.g. large ints to float.
+ */
+template<typename Weight, typename T>
+Weight checked_weight(const T w) {
+    bool fits;
+    if constexpr (std::is_integral_v<Weight> && std::is_integral_v<T>)
+        fits = w >= T{0}
+               ? static_cast<std::uintmax_t>(w) <= static_cast<std::uintmax_t>(std::numeric_limits<Weight>::max())
+               : std::is_signed_v<Weight>
+                 && static_cast<std::intmax_t>(w) >= static_cast<std::intmax_t>(std::numeric_limits<Weight>::min());
+    else if constexpr (std::is_integral_v<Weight>)
+        fits = std::trunc(w) == w && w >= static_cast<long double>(std::numeric_limits<Weight>::min())
+               && w <= static_cast<long double>(std::numeric_limits<Weight>::max());
+    else
+        fits = !std::isfinite(static_cast<long double>(w))
+               || std::fabs(static_cast<long double>(w)) <= static_cast<long double>(std::numeric_limits<Weight>::max());
+    if (!fits)
+        throw std::range_error((std::is_integral_v<T> ? "weight " + std::to_string(w) : std::string{"a weight"})
+                               + " doesn't fit in the graph's weight type");
+    return static_cast<Weight>(w);
+}
+
+/**
+ * Build a CSR graph from a range of undirected edges given as pairs of vertices, i.e. the same input as graph_t's
+ * edge iterator constructor. Each edge is stored in both directions so that BFS and Dijkstra see the same
+ * neighbourhoods they would see in the equivalent graph_t. The type of CSR graph can be chosen, e.g.
+ * make_csr<compact_csr_graph_t>(...). Throws std::range_error if the graph's types are too narrow (see check_csr_size).
+ */
+template<typename Graph = csr_graph_t, typename EdgeIterator>
+Graph make_csr(EdgeIterator begin, EdgeIterator end, const std::size_t n) {
+    using vertex = typename Graph::vertex_descriptor;
+    check_csr_size<Graph>(n, 2 * std::distance(begin, end));
+    std::vector<std::pair<vertex, vertex>> arcs;
+    arcs.reserve(2 * std::distance(begin, end));
+    for (; begin != end; ++begin) {
+        arcs.emplace_back(begin->first, begin->second);
+        arcs.emplace_back(begin->second, begin->first);
+    }
+
+    // The unsorted_multi_pass constructor does a counting sort on the sources, so no explicit sort is needed.
+    return Graph(boost::edges_are_unsorted_multi_pass, arcs.begin(), arcs.end(), n);
+}
+
+/**
+ * As make_csr, but with a parallel range of weights, one per undirected edge. Throws std::range_error if a weight
+ * doesn't fit in the graph's weight type (see checked_weight).
+ */
+template<typename Graph = weighted_csr_graph_t, typename EdgeIterator, typename WeightIterator>
+Graph make_weighted_csr(EdgeIterator begin, EdgeIterator end, WeightIterator wbegin, const std::size_t n) {
+    using vertex = typename Graph::vertex_descriptor;
+    using weight = typename boost::property_traits<typename boost::property_map<Graph, boost::edge_weight_t>::type>::value_type;
+    check_csr_size<Graph>(n, 2 * std::distance(begin, end));
+    std::vector<std::pair<vertex, vertex>> arcs;
+    std::vector<weight> weights;
+    arcs.reserve(2 * std::distance(begin, end));
+    weights.reserve(arcs.capacity());
+    for (; begin != end; ++begin, ++wbegin) {
+        arcs.emplace_back(begin->first, begin->second);
+        arcs.emplace_back(begin->second, begin->first);
+        const auto w = checked_weight<weight>(*wbegin);
+        weights.emplace_back(w);
+        weights.emplace_back(w);
+    }
+
+    return Graph(boost::edges_are_unsorted_multi_pass, arcs.begin(), arcs.end(), weights.begin(), n);
+}
+
+/** The CSR version of createCn_ep. **/
+csr_graph_t createCn_csr(const int n) {
+    std::vector<std::pair<int, int>> e;
+    for (auto i=0; i < n; ++i)
+        e.emplace_back(i, (i+1)%n);
+
+    return make_csr(e.begin(), e.end(), n);
+}
+
+/** The CSR version of createCn_weighted. **/
+template<unsigned long N>
+weighted_csr_graph_t createCn_weighted_csr(std::array<int, N> &weights) {
+    std::array<std::pair<int, int>, N> edges;
+    for (auto i=0; i < N; ++i)
+        edges[i] = std::make_pair(i, (i+3) % N);
+
+    return make_weighted_csr(edges.begin(), edges.end(), weights.begin(), N);
+}
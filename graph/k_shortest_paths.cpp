@@ -0,0 +1,133 @@
+/**
+ * k_shortest_paths.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Alternative routes: the k shortest loopless paths between two vertices, one query at a time and in batches.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+
+#include "graph_common.h"
+#include "k_shortest_paths.h"
+
+int main() {
+    // The graph from dijkstra_paths: the routes from 0 to 4.
+    {
+        int constexpr v = 8;
+        std::array<int, v> weights{{1, 3, 2, 4, 3, 1, 2, 3}};
+        weighted_graph_t g = createCn_weighted(weights);
+
+        k_shortest_paths_workspace<weighted_graph_t> workspace{g};
+        for (const auto &p: workspace.k_shortest_paths(0, 4, 4)) {
+            std::cout << "length " << p.length << ": ";
+            std::copy(p.vertices.begin(), p.vertices.end(), vout);
+            std::cout << std::endl;
+        }
+    }
+
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> wdist(1, 100);
+    const auto random_graph = [&](const std::size_t v, const std::size_t e) {
+        std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+        std::vector<std::pair<std::size_t, std::size_t>> edges;
+        std::vector<int> weights;
+        for (std::size_t i = 0; i < e; ++i) {
+            edges.emplace_back(vdist(gen), vdist(gen));
+            weights.emplace_back(wdist(gen));
+        }
+        return weighted_graph_t(edges.begin(), edges.end(), weights.begin(), v);
+    };
+
+    // On a small graph, check the lengths against every simple path, found by brute force.
+    {
+        constexpr std::size_t v = 10;
+        constexpr std::size_t k = 12;
+        const auto g = random_graph(v, 22);
+        k_shortest_paths_workspace<weighted_graph_t> workspace{g};
+
+        std::size_t mismatches = 0;
+        for (std::size_t s = 0; s < v; ++s)
+            for (std::size_t t = 0; t < v; ++t) {
+                std::vector<int> lengths;
+                std::vector<char> on_path(v, 0);
+                const std::function<void(std::size_t, int)> extend = [&](const std::size_t u, const int length) {
+                    if (u == t) {
+                        lengths.emplace_back(length);
+                        return;
+                    }
+                    on_path[u] = 1;
+                    for (auto [eit, eend] = boost::out_edges(u, g); eit != eend; ++eit)
+                        if (!on_path[boost::target(*eit, g)])
+                            extend(boost::target(*eit, g), length + boost::get(boost::edge_weight, g, *eit));
+                    on_path[u] = 0;
+                };
+                extend(s, 0);
+                std::sort(lengths.begin(), lengths.end());
+                lengths.resize(std::min(k, lengths.size()));
+
+                std::vector<int> found;
+                for (const auto &p: workspace.k_shortest_paths(s, t, k))
+                    found.emplace_back(p.length);
+                mismatches += found != lengths;
+            }
+        std::cout << "Brute force mismatches: " << mismatches << std::endl;
+    }
+
+    // A batch of queries on a big graph: 20 sources with 10 targets each. Asked in an arbitrary order, each query
+    // needs its own tree; grouped by source, each tree serves 10 queries.
+    {
+        constexpr std::size_t v = 100000;
+        constexpr std::size_t k = 5;
+        const auto g = random_graph(v, 300000);
+
+        std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+        std::vector<route_query> queries;
+        std::vector<std::size_t> sources(20);
+        for (auto &s: sources)
+            s = vdist(gen);
+        for (std::size_t i = 0; i < 10; ++i)
+            for (const auto s: sources)
+                queries.push_back({s, vdist(gen), k});
+
+        const auto lengths = [](const auto &paths) {
+            std::vector<int> result;
+            for (const auto &p: paths)
+                result.emplace_back(p.length);
+            return result;
+        };
+
+        k_shortest_paths_workspace<weighted_graph_t> workspace{g};
+        std::vector<std::vector<int>> one_by_one;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto &q: queries)
+            one_by_one.emplace_back(lengths(workspace.k_shortest_paths(q.source, q.target, q.k)));
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "One by one: " << elapsed.count() / queries.size() << " ms per query, "
+                  << workspace.spur_searches() << " spur searches settling " << workspace.settled() << " vertices"
+                  << std::endl;
+
+        route_planner<weighted_graph_t> planner{g};
+        start = std::chrono::steady_clock::now();
+        const auto batch = planner.solve(queries);
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Batched on " << planner.threads() << " threads: " << elapsed.count() / queries.size()
+                  << " ms per query" << std::endl;
+
+        bool same = true;
+        for (std::size_t i = 0; i < queries.size(); ++i)
+            same = same && lengths(batch[i]) == one_by_one[i];
+        std::cout << "Same lengths: " << std::boolalpha << same << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,335 @@
+/**
+ * k_shortest_paths.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * The k shortest loopless paths between two vertices, for offering alternative routes, and answering batches of
+ * such queries.
+ *
+ * dijkstra_paths.cpp gives one path per target: the one in the shortest path tree. Yen's algorithm (1971) finds
+ * the next best paths by deviating from the ones already found. For each vertex (the spur) on the last path found, it
+ * keeps the path up to the spur (the root), forbids the root's other vertices and every edge out of the spur that an
+ * earlier path with the same root took, and searches for the shortest way on from the spur to the target. Each such
+ * search gives a candidate, and the best candidate is the next path. Three things keep the searches cheap:
+ *
+ * 1. As suggested by Lawler (1972), a path only needs spurs from the point where it deviated from its parent: the
+ *    earlier spurs were tried when the parent was found.
+ *
+ * 2. The graph is undirected, so the paths are found backwards, from t to s, and the spur searches head for s. The
+ *    shortest path tree from s then gives the exact distance from every vertex to s, and the spur searches are A*
+ *    searches guided by it: forbidding vertices and edges can only make distances longer, so it is still a lower
+ *    bound. Unless the forbidden vertices are in the way, a spur search walks straight down the tree.
+ *
+ * 3. The tree from s is computed once, and shared by all of the queries from s: it also gives their first paths for
+ *    free. A route_planner sorts a batch of queries by source, and hands the groups out to its threads.
+ *
+ * Like a dijkstra_workspace, a k_shortest_paths_workspace keeps its arrays between queries and only resets the
+ * entries each spur search touched. The graph must be undirected, with non-negative weights.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+/** A path, as its vertices from the source to the target, and its length. **/
+template<typename Vertex, typename Distance>
+struct route {
+    Distance length;
+    std::vector<Vertex> vertices;
+};
+
+/** A request for the k shortest paths from source to target, by vertex index. **/
+struct route_query {
+    std::size_t source;
+    std::size_t target;
+    std::size_t k;
+};
+
+/**
+ * Reusable state for k shortest paths queries on a fixed graph. The tree of the last source is kept, so queries from
+ * the same source should be asked together. A workspace is not thread-safe: use one per thread.
+ */
+template<typename Graph,
+        typename WeightMap = typename boost::property_map<Graph, boost::edge_weight_t>::const_type>
+class k_shortest_paths_workspace {
+    static_assert(boost::is_undirected_graph<Graph>::value, "k_shortest_paths_workspace needs an undirected graph.");
+
+public:
+    using vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
+    using distance_type = typename boost::property_traits<WeightMap>::value_type;
+    using path = route<vertex, distance_type>;
+
+    explicit k_shortest_paths_workspace(const Graph &g)
+            : k_shortest_paths_workspace(g, boost::get(boost::edge_weight, g)) {}
+
+    k_shortest_paths_workspace(const Graph &g, WeightMap weight)
+            : g_{g}, weight_{weight},
+              tree_dist_(boost::num_vertices(g)), tree_pred_(boost::num_vertices(g)),
+              dist_(boost::num_vertices(g), infinity), pred_(boost::num_vertices(g), none),
+              banned_(boost::num_vertices(g), 0) {}
+
+    /** Compute the shortest path tree from s, for the queries that follow. **/
+    void set_source(const vertex s) {
+        source_ = index(s);
+        const auto vindex = boost::get(boost::vertex_index, g_);
+        boost::dijkstra_shortest_paths(g_, s, boost::weight_map(weight_)
+                .distance_map(boost::make_iterator_property_map(tree_dist_.begin(), vindex))
+                .predecessor_map(boost::make_iterator_property_map(tree_pred_.begin(), vindex)));
+    }
+
+    /** The k shortest loopless paths from s to t, shortest first. There may be fewer than k. **/
+    std::vector<path> k_shortest_paths(const vertex s, const vertex t, const std::size_t k) {
+        if (index(s) != source_)
+            set_source(s);
+        return k_shortest_paths(t, k);
+    }
+
+    /** As above, from the source of the last query or set_source. **/
+    std::vector<path> k_shortest_paths(const vertex target, const std::size_t k) {
+        const auto t = index(target);
+        std::vector<path> result;
+        if (k == 0 || tree_dist_[t] == infinity)
+            return result;
+
+        // The candidates run from t to the source.
+        std::vector<candidate> accepted{tree_path(t)};
+        std::vector<candidate> candidates;
+        std::set<std::vector<std::size_t>> seen{accepted.front().vertices};
+        const auto longer = [](const candidate &a, const candidate &b) { return a.length() > b.length(); };
+
+        while (accepted.size() < k) {
+            const auto last = accepted.size() - 1;
+            for (auto j = accepted[last].deviation; j + 1 < accepted[last].vertices.size(); ++j) {
+                const auto &root = accepted[last].vertices;
+                for (std::size_t i = 0; i < j; ++i)
+                    banned_[root[i]] = 1;
+                banned_hops_.clear();
+                for (const auto &p: accepted)
+                    if (p.vertices.size() > j + 1 && std::equal(root.begin(), root.begin() + j + 1, p.vertices.begin()))
+                        banned_hops_.emplace_back(p.vertices[j + 1]);
+
+                if (spur_search(root[j])) {
+                    candidate c;
+                    c.vertices.assign(root.begin(), root.begin() + j);
+                    c.prefix.assign(accepted[last].prefix.begin(), accepted[last].prefix.begin() + j);
+                    const auto spur_start = c.vertices.size();
+                    for (auto v = source_; v != root[j]; v = pred_[v]) {
+                        c.vertices.emplace_back(v);
+                        c.prefix.emplace_back(accepted[last].prefix[j] + dist_[v]);
+                    }
+                    c.vertices.emplace_back(root[j]);
+                    c.prefix.emplace_back(accepted[last].prefix[j]);
+                    std::reverse(c.vertices.begin() + spur_start, c.vertices.end());
+                    std::reverse(c.prefix.begin() + spur_start, c.prefix.end());
+                    c.deviation = j;
+                    if (seen.insert(c.vertices).second) {
+                        candidates.emplace_back(std::move(c));
+                        std::push_heap(candidates.begin(), candidates.end(), longer);
+                    }
+                }
+
+                for (std::size_t i = 0; i < j; ++i)
+                    banned_[accepted[last].vertices[i]] = 0;
+            }
+
+            if (candidates.empty())
+                break;
+            std::pop_heap(candidates.begin(), candidates.end(), longer);
+            accepted.emplace_back(std::move(candidates.back()));
+            candidates.pop_back();
+        }
+
+        for (const auto &c: accepted) {
+            path p{c.length(), {}};
+            p.vertices.reserve(c.vertices.size());
+            for (auto it = c.vertices.rbegin(); it != c.vertices.rend(); ++it)
+                p.vertices.emplace_back(boost::vertex(*it, g_));
+            result.emplace_back(std::move(p));
+        }
+        return result;
+    }
+
+    /** The number of spur searches run so far, and the vertices they settled, for gauging the work done. **/
+    std::size_t spur_searches() const { return spur_searches_; }
+    std::size_t settled() const { return settled_; }
+
+private:
+    static constexpr auto infinity = std::numeric_limits<distance_type>::max();
+    static constexpr auto none = std::numeric_limits<std::size_t>::max();
+
+    using entry = std::pair<distance_type, std::size_t>;
+
+    /** A path by vertex index, with the distance from its start to each of its vertices. **/
+    struct candidate {
+        std::vector<std::size_t> vertices;
+        std::vector<distance_type> prefix;
+        // The index of the spur this path left its parent at.
+        std::size_t deviation = 0;
+
+        distance_type length() const { return prefix.back(); }
+    };
+
+    std::size_t index(const vertex v) const {
+        return boost::get(boost::vertex_index, g_, v);
+    }
+
+    /** The path from t to the source in the tree. **/
+    candidate tree_path(const std::size_t t) const {
+        candidate c;
+        for (auto v = t; ; v = index(tree_pred_[v])) {
+            c.vertices.emplace_back(v);
+            c.prefix.emplace_back(tree_dist_[t] - tree_dist_[v]);
+            if (v == source_)
+                break;
+        }
+        return c;
+    }
+
+    /**
+     * A* from the spur to the source, avoiding the banned vertices, and the banned hops out of the spur. On success,
+     * dist_ and pred_ hold the path back from the source.
+     */
+    bool spur_search(const std::size_t spur) {
+        for (const auto v: touched_) {
+            dist_[v] = infinity;
+            pred_[v] = none;
+        }
+        touched_.clear();
+        heap_.clear();
+        ++spur_searches_;
+
+        const auto update = [&](const std::size_t v, const distance_type d, const std::size_t p) {
+            if (dist_[v] == infinity)
+                touched_.emplace_back(v);
+            dist_[v] = d;
+            pred_[v] = p;
+            heap_.emplace_back(d + tree_dist_[v], v);
+            std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+        };
+
+        update(spur, 0, spur);
+        while (!heap_.empty()) {
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+            const auto [f, u] = heap_.back();
+            heap_.pop_back();
+            // Stale entries are for vertices that have improved since they were pushed.
+            if (f != dist_[u] + tree_dist_[u])
+                continue;
+            ++settled_;
+            if (u == source_)
+                return true;
+
+            for (auto [eit, eend] = boost::out_edges(boost::vertex(u, g_), g_); eit != eend; ++eit) {
+                const auto v = index(boost::target(*eit, g_));
+                if (banned_[v] || (u == spur && std::find(banned_hops_.begin(), banned_hops_.end(), v) != banned_hops_.end()))
+                    continue;
+                const auto dv = dist_[u] + boost::get(weight_, *eit);
+                if (dv < dist_[v])
+                    update(v, dv, u);
+            }
+        }
+        return false;
+    }
+
+    const Graph &g_;
+    WeightMap weight_;
+
+    // The shared tree from the source.
+    std::size_t source_ = none;
+    std::vector<distance_type> tree_dist_;
+    std::vector<vertex> tree_pred_;
+
+    // The scratch space of the spur searches.
+    std::vector<distance_type> dist_;
+    std::vector<std::size_t> pred_;
+    std::vector<char> banned_;
+    std::vector<std::size_t> banned_hops_;
+    std::vector<std::size_t> touched_;
+    std::vector<entry> heap_;
+
+    std::size_t spur_searches_ = 0;
+    std::size_t settled_ = 0;
+};
+
+/**
+ * Answers batches of route_queries on a fixed graph with several threads (0 means one per core). The queries are
+ * grouped by source, so that each group shares one shortest path tree, and the groups are handed out to the threads
+ * as they become free. Each thread has its own workspace, which is kept from one batch to the next.
+ */
+template<typename Graph,
+        typename WeightMap = typename boost::property_map<Graph, boost::edge_weight_t>::const_type>
+class route_planner {
+public:
+    using workspace = k_shortest_paths_workspace<Graph, WeightMap>;
+    using path = typename workspace::path;
+
+    explicit route_planner(const Graph &g, const unsigned threads = 0)
+            : route_planner(g, boost::get(boost::edge_weight, g), threads) {}
+
+    route_planner(const Graph &g, WeightMap weight, const unsigned threads = 0)
+            : g_{g}, weight_{weight}, threads_{std::max(1u, threads ? threads : std::thread::hardware_concurrency())} {}
+
+    /** The answers to the queries, in the same order. **/
+    std::vector<std::vector<path>> solve(const std::vector<route_query> &queries) {
+        std::vector<std::size_t> order(queries.size());
+        for (std::size_t i = 0; i < order.size(); ++i)
+            order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](const std::size_t a, const std::size_t b) {
+            return queries[a].source < queries[b].source;
+        });
+
+        // groups[i] is where the i-th group of queries with the same source starts in order.
+        std::vector<std::size_t> groups;
+        for (std::size_t i = 0; i < order.size(); ++i)
+            if (i == 0 || queries[order[i]].source != queries[order[i - 1]].source)
+                groups.emplace_back(i);
+        groups.emplace_back(order.size());
+
+        const auto threads = static_cast<unsigned>(std::min<std::size_t>(threads_, groups.size() - 1));
+        while (workspaces_.size() < threads)
+            workspaces_.emplace_back(g_, weight_);
+
+        std::vector<std::vector<path>> results(queries.size());
+        std::atomic<std::size_t> next{0};
+        const auto work = [&](workspace &w) {
+            for (auto group = next++; group + 1 < groups.size(); group = next++) {
+                w.set_source(boost::vertex(queries[order[groups[group]]].source, g_));
+                for (auto i = groups[group]; i < groups[group + 1]; ++i) {
+                    const auto &q = queries[order[i]];
+                    results[order[i]] = w.k_shortest_paths(boost::vertex(q.target, g_), q.k);
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < threads; ++t)
+            workers.emplace_back(work, std::ref(workspaces_[t]));
+        if (threads)
+            work(workspaces_.front());
+        for (auto &w: workers)
+            w.join();
+        return results;
+    }
+
+    unsigned threads() const { return threads_; }
+
+private:
+    const Graph &g_;
+    WeightMap weight_;
+    unsigned threads_;
+    std::vector<workspace> workspaces_;
+};
@@ -0,0 +1,110 @@
+/**
+ * mapped.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Writing a graph to the binary mapped format, and searching it straight out of the file.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+// The mapped graph has to come before the algorithms.
+#include "mapped_graph.h"
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/visitors.hpp>
+
+#include "graph_common.h"
+
+int main() {
+    constexpr std::size_t v = 200000;
+    constexpr std::size_t e = 1000000;
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+    std::uniform_int_distribution<int> wdist(1, 100);
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    std::vector<int> weights;
+    for (std::size_t i = 0; i < e; ++i) {
+        edges.emplace_back(vdist(gen), vdist(gen));
+        weights.emplace_back(wdist(gen));
+    }
+
+    // Times a function and reports how long it took.
+    const auto timed = [](const char *name, auto &&f) {
+        const auto start = std::chrono::steady_clock::now();
+        auto result = f();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << name << ": " << elapsed.count() << " ms" << std::endl;
+        return result;
+    };
+
+    const auto g = timed("Build weighted_graph_t", [&] {
+        return weighted_graph_t(edges.begin(), edges.end(), weights.begin(), v);
+    });
+    timed("Write graph.bin", [&] {
+        write_mapped_graph(g, boost::get(boost::edge_weight, g), "graph.bin");
+        return 0;
+    });
+    timed("Map graph.bin, trusted", [] { return mapped_graph{"graph.bin", mapped_graph::trusted}; });
+    const auto m = timed("Map and check graph.bin", [] { return mapped_graph{"graph.bin"}; });
+    std::cout << "Vertices: " << boost::num_vertices(m) << ", arcs: " << boost::num_edges(m) << std::endl;
+
+    // BFS on both.
+    std::vector<int> expected(v, 0);
+    boost::breadth_first_search(g, 0,
+        boost::visitor(boost::make_bfs_visitor(boost::record_distances(expected.data(), boost::on_tree_edge{}))));
+    std::vector<int> distances(v, 0);
+    timed("BFS on the mapping", [&] {
+        boost::breadth_first_search(m, 0,
+            boost::visitor(boost::make_bfs_visitor(boost::record_distances(distances.data(), boost::on_tree_edge{}))));
+        return 0;
+    });
+    std::cout << "Same BFS distances: " << std::boolalpha << (distances == expected) << std::endl;
+
+    // Dijkstra on both, with the weights read from the file.
+    boost::dijkstra_shortest_paths(g, 0, boost::distance_map(
+            boost::make_iterator_property_map(expected.begin(), boost::get(boost::vertex_index, g))));
+    timed("Dijkstra on the mapping", [&] {
+        boost::dijkstra_shortest_paths(m, 0, boost::distance_map(
+                boost::make_iterator_property_map(distances.begin(), boost::get(boost::vertex_index, m))));
+        return 0;
+    });
+    std::cout << "Same Dijkstra distances: " << (distances == expected) << std::endl;
+
+    // An unweighted graph can be written too, but has no weights to read.
+    write_mapped_graph(createCn_ep(10), "cycle.bin");
+    const mapped_graph cycle{"cycle.bin"};
+    std::cout << "C10: " << boost::num_edges(cycle) << " arcs, weighted: " << cycle.weighted() << std::endl;
+
+    // Anything that isn't a mapped graph is refused.
+    std::ofstream{"bogus.bin"} << "This is long enough to hold a header, but it is certainly not a graph.";
+    try {
+        mapped_graph{"bogus.bin"};
+    } catch (const std::exception &ex) {
+        std::cout << "Refused: " << ex.what() << std::endl;
+    }
+
+    // So is a mapped graph whose last arc leads nowhere.
+    {
+        std::fstream corrupt{"cycle.bin", std::ios::binary | std::ios::in | std::ios::out};
+        corrupt.seekp(-static_cast<std::streamoff>(sizeof(std::uint32_t)), std::ios::end);
+        const std::uint32_t nowhere = 1000;
+        corrupt.write(reinterpret_cast<const char *>(&nowhere), sizeof nowhere);
+    }
+    try {
+        mapped_graph{"cycle.bin"};
+    } catch (const std::exception &ex) {
+        std::cout << "Refused: " << ex.what() << std::endl;
+    }
+
+    return 0;
+}
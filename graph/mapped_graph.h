@@ -0,0 +1,446 @@
+/**
+ * mapped_graph.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * A binary on-disk graph format that is used in place through a memory mapping.
+ *
+ * write_graphviz produces text that has to be parsed and turned back into an adjacency list, edge by edge. Here,
+ * the file is laid out exactly like a CSR graph in memory:
+ *
+ *     header     magic, version, byte order, flags, vertex and arc counts, and where each section starts
+ *     offsets    num_vertices + 1 uint64_t: the arcs of vertex v are [offsets[v], offsets[v + 1])
+ *     targets    num_arcs uint32_t
+ *     weights    num_arcs int32_t, if the graph is weighted
+ *
+ * Each section starts on an 8-byte boundary. A mapped_graph maps the file read-only and reads the arrays straight
+ * out of the mapping. By default, opening a file checks the offsets and targets once, so that a corrupt file is
+ * refused rather than read out of bounds; files known to be good can be opened with mapped_graph::trusted, and
+ * then opening costs the same whatever the size: the pages are only read from disk (or the page cache) when a
+ * traversal first touches them.
+ *
+ * As with csr_graph_t, undirected graphs are stored with each edge in both directions. The file is in the byte order
+ * of the machine that wrote it, and opening it on a machine with the other byte order fails.
+ *
+ * mapped_graph models VertexListGraph, IncidenceGraph and AdjacencyGraph, and has vertex_index, edge_index and
+ * edge_weight properties, so the Boost algorithms run on it directly. As with torus_graph.h, the free functions
+ * live in the global namespace and are brought into boost, so include this header before the algorithms.
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_iterator.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include "graph_common.h"
+
+/** The first bytes of a mapped graph file. **/
+struct mapped_graph_header {
+    static constexpr char expected_magic[8] = {'B', 'G', 'L', 'G', 'R', 'A', 'P', 'H'};
+    static constexpr std::uint32_t current_version = 1;
+    static constexpr std::uint32_t native_byte_order = 0x01020304;
+    static constexpr std::uint32_t weighted_flag = 1;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t flags;
+    std::uint32_t reserved;
+    std::uint64_t num_vertices;
+    std::uint64_t num_arcs;
+
+    // Where each section starts, in bytes from the start of the file. weights_at is 0 for unweighted graphs.
+    std::uint64_t offsets_at;
+    std::uint64_t targets_at;
+    std::uint64_t weights_at;
+};
+
+/** An arc of a mapped_graph: its source, and its position in the targets (and weights) array. **/
+struct mapped_edge {
+    std::uint32_t source;
+    std::uint64_t index;
+};
+
+inline bool operator==(const mapped_edge &a, const mapped_edge &b) { return a.index == b.index; }
+inline bool operator!=(const mapped_edge &a, const mapped_edge &b) { return a.index != b.index; }
+
+class mapped_graph;
+
+namespace detail {
+    /** Iterates over the arcs of one vertex, i.e. over a range of positions in the targets array. **/
+    class mapped_out_edge_iterator : public boost::iterator_facade<mapped_out_edge_iterator, mapped_edge,
+            std::random_access_iterator_tag, mapped_edge, std::ptrdiff_t> {
+    public:
+        mapped_out_edge_iterator() = default;
+        mapped_out_edge_iterator(const std::uint32_t source, const std::uint64_t index)
+                : source_{source}, index_{index} {}
+
+    private:
+        friend class boost::iterator_core_access;
+
+        mapped_edge dereference() const { return {source_, index_}; }
+        bool equal(const mapped_out_edge_iterator &other) const { return index_ == other.index_; }
+        void increment() { ++index_; }
+        void decrement() { --index_; }
+        void advance(const std::ptrdiff_t n) { index_ += n; }
+        std::ptrdiff_t distance_to(const mapped_out_edge_iterator &other) const {
+            return static_cast<std::ptrdiff_t>(other.index_) - static_cast<std::ptrdiff_t>(index_);
+        }
+
+        std::uint32_t source_ = 0;
+        std::uint64_t index_ = 0;
+    };
+}
+
+/** A read-only graph backed by a memory-mapped file written by write_mapped_graph. **/
+class mapped_graph {
+public:
+    // The Boost.Graph traits.
+    using vertex_descriptor = std::uint32_t;
+    using edge_descriptor = mapped_edge;
+    using directed_category = boost::directed_tag;
+    using edge_parallel_category = boost::allow_parallel_edge_tag;
+    struct traversal_category : boost::vertex_list_graph_tag, boost::incidence_graph_tag,
+                                boost::adjacency_graph_tag {};
+
+    using vertices_size_type = std::size_t;
+    using edges_size_type = std::size_t;
+    using degree_size_type = std::size_t;
+
+    using vertex_iterator = boost::counting_iterator<std::uint32_t>;
+    using out_edge_iterator = detail::mapped_out_edge_iterator;
+    using adjacency_iterator = typename boost::adjacency_iterator_generator<mapped_graph,
+            vertex_descriptor, out_edge_iterator>::type;
+
+    static vertex_descriptor null_vertex() { return std::numeric_limits<std::uint32_t>::max(); }
+
+    /** Tag for the constructor that skips the linear validation pass. **/
+    struct trusted_t {};
+    static constexpr trusted_t trusted{};
+
+    /**
+     * Map the given file, and check it once from end to end: the header, the section bounds, and that the offsets
+     * never decrease and every target is a vertex. Throws std::runtime_error if it isn't a mapped graph that this
+     * machine can read. The check reads the offsets and targets once, so it costs O(V + E).
+     */
+    explicit mapped_graph(const std::string &filename) : mapped_graph{filename, trusted} {
+        validate(filename);
+    }
+
+    /**
+     * Map a file without reading its offsets and targets, so that opening costs the same whatever the size.
+     * The header and section bounds are still checked, but the contents are trusted: only use this on files that
+     * were written by write_mapped_graph, since corrupt offsets or targets make traversals read out of bounds.
+     */
+    mapped_graph(const std::string &filename, trusted_t)
+            : file_{filename.c_str(), boost::interprocess::read_only},
+              region_{file_, boost::interprocess::read_only} {
+        const auto base = static_cast<const char *>(region_.get_address());
+        const auto size = region_.get_size();
+
+        if (size < sizeof(mapped_graph_header))
+            throw std::runtime_error(filename + ": too short to be a mapped graph");
+        std::memcpy(&header_, base, sizeof header_);
+        if (std::memcmp(header_.magic, mapped_graph_header::expected_magic, sizeof header_.magic) != 0)
+            throw std::runtime_error(filename + ": not a mapped graph");
+        if (header_.version != mapped_graph_header::current_version)
+            throw std::runtime_error(filename + ": unsupported version " + std::to_string(header_.version));
+        if (header_.byte_order != mapped_graph_header::native_byte_order)
+            throw std::runtime_error(filename + ": written with a different byte order");
+
+        // Vertices are 32 bits, and the largest value is null_vertex.
+        if (header_.num_vertices >= null_vertex())
+            throw std::runtime_error(filename + ": too many vertices for a mapped graph");
+
+        // Each section has to start on an 8-byte boundary of the mapping, and count * width bytes from there
+        // (computed without wrapping around) have to lie inside the file.
+        const auto fits = [base, size](const std::uint64_t at, const std::uint64_t count, const std::size_t width) {
+            return (reinterpret_cast<std::uintptr_t>(base) + at) % 8 == 0 && at <= size
+                   && count <= (size - at) / width;
+        };
+        const bool weighted = header_.flags & mapped_graph_header::weighted_flag;
+        if (!fits(header_.offsets_at, header_.num_vertices + 1, sizeof(std::uint64_t))
+            || !fits(header_.targets_at, header_.num_arcs, sizeof(std::uint32_t))
+            || (weighted && !fits(header_.weights_at, header_.num_arcs, sizeof(std::int32_t))))
+            throw std::runtime_error(filename + ": truncated or misaligned");
+
+        offsets_ = reinterpret_cast<const std::uint64_t *>(base + header_.offsets_at);
+        targets_ = reinterpret_cast<const std::uint32_t *>(base + header_.targets_at);
+        weights_ = weighted ? reinterpret_cast<const std::int32_t *>(base + header_.weights_at) : nullptr;
+        if (offsets_[0] != 0 || offsets_[header_.num_vertices] != header_.num_arcs)
+            throw std::runtime_error(filename + ": offsets don't match the number of arcs");
+    }
+
+    std::size_t num_vertices() const { return header_.num_vertices; }
+    std::size_t num_edges() const { return header_.num_arcs; }
+    bool weighted() const { return weights_ != nullptr; }
+
+    std::pair<out_edge_iterator, out_edge_iterator> out_edges(const vertex_descriptor v) const {
+        return {out_edge_iterator{v, offsets_[v]}, out_edge_iterator{v, offsets_[v + 1]}};
+    }
+
+    std::size_t out_degree(const vertex_descriptor v) const { return offsets_[v + 1] - offsets_[v]; }
+    vertex_descriptor target(const mapped_edge &e) const { return targets_[e.index]; }
+
+    /** The weight of an arc. Only valid if the graph is weighted. **/
+    std::int32_t weight(const mapped_edge &e) const {
+        assert(weights_ != nullptr);
+        return weights_[e.index];
+    }
+
+private:
+    /** The linear pass: the offsets never decrease, and every target is a vertex. **/
+    void validate(const std::string &filename) const {
+        const auto n = header_.num_vertices;
+        for (std::uint64_t v = 0; v < n; ++v)
+            if (offsets_[v] > offsets_[v + 1])
+                throw std::runtime_error(filename + ": offsets of vertex " + std::to_string(v) + " decrease");
+        for (std::uint64_t i = 0; i < header_.num_arcs; ++i)
+            if (targets_[i] >= n)
+                throw std::runtime_error(filename + ": arc " + std::to_string(i) + " leads to no vertex");
+    }
+
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+    mapped_graph_header header_{};
+    const std::uint64_t *offsets_ = nullptr;
+    const std::uint32_t *targets_ = nullptr;
+    const std::int32_t *weights_ = nullptr;
+};
+
+// The Boost.Graph interface.
+
+inline std::pair<mapped_graph::vertex_iterator, mapped_graph::vertex_iterator> vertices(const mapped_graph &g) {
+    return {mapped_graph::vertex_iterator{0},
+            mapped_graph::vertex_iterator{static_cast<std::uint32_t>(g.num_vertices())}};
+}
+
+inline std::size_t num_vertices(const mapped_graph &g) { return g.num_vertices(); }
+
+inline std::size_t num_edges(const mapped_graph &g) { return g.num_edges(); }
+
+inline std::uint32_t source(const mapped_edge &e, const mapped_graph &) { return e.source; }
+
+inline std::uint32_t target(const mapped_edge &e, const mapped_graph &g) { return g.target(e); }
+
+inline std::pair<mapped_graph::out_edge_iterator, mapped_graph::out_edge_iterator>
+out_edges(const std::uint32_t v, const mapped_graph &g) { return g.out_edges(v); }
+
+inline std::size_t out_degree(const std::uint32_t v, const mapped_graph &g) { return g.out_degree(v); }
+
+inline std::pair<mapped_graph::adjacency_iterator, mapped_graph::adjacency_iterator>
+adjacent_vertices(const std::uint32_t v, const mapped_graph &g) {
+    const auto [first, last] = g.out_edges(v);
+    return {mapped_graph::adjacency_iterator{first, &g}, mapped_graph::adjacency_iterator{last, &g}};
+}
+
+inline std::uint32_t vertex(const std::size_t i, const mapped_graph &) { return static_cast<std::uint32_t>(i); }
+
+/** The edge_index property of a mapped_graph: the position of the arc in the file. **/
+class mapped_edge_index_map : public boost::put_get_helper<std::size_t, mapped_edge_index_map> {
+public:
+    using key_type = mapped_edge;
+    using value_type = std::size_t;
+    using reference = std::size_t;
+    using category = boost::readable_property_map_tag;
+
+    std::size_t operator[](const mapped_edge &e) const { return e.index; }
+};
+
+/** The edge_weight property of a weighted mapped_graph, read straight from the mapping. **/
+class mapped_weight_map : public boost::put_get_helper<std::int32_t, mapped_weight_map> {
+public:
+    using key_type = mapped_edge;
+    using value_type = std::int32_t;
+    using reference = std::int32_t;
+    using category = boost::readable_property_map_tag;
+
+    explicit mapped_weight_map(const mapped_graph &g) : g_{&g} {}
+
+    std::int32_t operator[](const mapped_edge &e) const { return g_->weight(e); }
+
+private:
+    const mapped_graph *g_;
+};
+
+inline boost::typed_identity_property_map<std::uint32_t> get(boost::vertex_index_t, const mapped_graph &) { return {}; }
+
+inline std::uint32_t get(boost::vertex_index_t, const mapped_graph &, const std::uint32_t v) { return v; }
+
+inline mapped_edge_index_map get(boost::edge_index_t, const mapped_graph &) { return {}; }
+
+inline std::size_t get(boost::edge_index_t, const mapped_graph &, const mapped_edge &e) { return e.index; }
+
+inline mapped_weight_map get(boost::edge_weight_t, const mapped_graph &g) {
+    if (!g.weighted())
+        throw std::logic_error("the mapped graph has no weights");
+    return mapped_weight_map{g};
+}
+
+inline std::int32_t get(boost::edge_weight_t, const mapped_graph &g, const mapped_edge &e) { return g.weight(e); }
+
+namespace boost {
+    template<>
+    struct property_map<mapped_graph, vertex_index_t> {
+        using type = typed_identity_property_map<std::uint32_t>;
+        using const_type = type;
+    };
+
+    template<>
+    struct property_map<mapped_graph, edge_index_t> {
+        using type = mapped_edge_index_map;
+        using const_type = type;
+    };
+
+    template<>
+    struct property_map<mapped_graph, edge_weight_t> {
+        using type = mapped_weight_map;
+        using const_type = type;
+    };
+
+    using ::vertices;
+    using ::num_vertices;
+    using ::num_edges;
+    using ::source;
+    using ::target;
+    using ::out_edges;
+    using ::out_degree;
+    using ::adjacent_vertices;
+    using ::vertex;
+    using ::get;
+}
+
+// The writers call the Boost.Graph functions unqualified, so that they are found by argument-dependent lookup for
+// graph types declared after this header.
+
+namespace detail {
+    constexpr std::uint64_t mapped_align(const std::uint64_t at) { return (at + 7) / 8 * 8; }
+
+    /** Write zeros up to the given position, which is at most 7 bytes on. **/
+    inline void pad_to(std::ofstream &out, const std::uint64_t at) {
+        static constexpr char zeros[8] = {};
+        out.write(zeros, static_cast<std::streamsize>(at - static_cast<std::uint64_t>(out.tellp())));
+    }
+
+    /** Write the header and offsets of g, and return its vertices in index order. **/
+    template<typename Graph>
+    std::vector<typename boost::graph_traits<Graph>::vertex_descriptor>
+    write_mapped_layout(std::ofstream &out, const Graph &g, const bool weighted) {
+        const std::size_t n = num_vertices(g);
+        if (n >= std::numeric_limits<std::uint32_t>::max())
+            throw std::runtime_error("too many vertices for a mapped graph");
+
+        const auto index = get(boost::vertex_index, g);
+        std::vector<typename boost::graph_traits<Graph>::vertex_descriptor> by_index(n);
+        for (auto [vit, vend] = vertices(g); vit != vend; ++vit)
+            by_index[get(index, *vit)] = *vit;
+
+        std::vector<std::uint64_t> offsets(n + 1, 0);
+        for (std::size_t v = 0; v < n; ++v)
+            offsets[v + 1] = offsets[v] + out_degree(by_index[v], g);
+        const auto m = offsets[n];
+
+        mapped_graph_header header{};
+        std::memcpy(header.magic, mapped_graph_header::expected_magic, sizeof header.magic);
+        header.version = mapped_graph_header::current_version;
+        header.byte_order = mapped_graph_header::native_byte_order;
+        header.flags = weighted ? mapped_graph_header::weighted_flag : 0;
+        header.num_vertices = n;
+        header.num_arcs = m;
+        header.offsets_at = mapped_align(sizeof header);
+        header.targets_at = mapped_align(header.offsets_at + (n + 1) * sizeof(std::uint64_t));
+        header.weights_at = weighted ? mapped_align(header.targets_at + m * sizeof(std::uint32_t)) : 0;
+
+        out.write(reinterpret_cast<const char *>(&header), sizeof header);
+        pad_to(out, header.offsets_at);
+        out.write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(std::uint64_t));
+        pad_to(out, header.targets_at);
+        return by_index;
+    }
+
+    /** Write the values of f over the arcs of g, in file order, a block at a time. **/
+    template<typename T, typename Graph, typename Vertices, typename F>
+    void write_mapped_arcs(std::ofstream &out, const Graph &g, const Vertices &by_index, F &&f) {
+        std::vector<T> block;
+        block.reserve(1 << 16);
+        const auto flush = [&] {
+            out.write(reinterpret_cast<const char *>(block.data()), block.size() * sizeof(T));
+            block.clear();
+        };
+        for (const auto v: by_index)
+            for (auto [eit, eend] = out_edges(v, g); eit != eend; ++eit) {
+                block.emplace_back(f(*eit));
+                if (block.size() == block.capacity())
+                    flush();
+            }
+        flush();
+    }
+}
+
+/** Write an unweighted graph, such as a graph_t or csr_graph_t, to a file that mapped_graph can open. **/
+template<typename Graph>
+void write_mapped_graph(const Graph &g, const std::string &filename) {
+    std::ofstream out{filename, std::ios::binary | std::ios::trunc};
+    if (!out)
+        throw std::runtime_error(filename + ": cannot open for writing");
+
+    const auto index = get(boost::vertex_index, g);
+    const auto by_index = detail::write_mapped_layout(out, g, false);
+    detail::write_mapped_arcs<std::uint32_t>(out, g, by_index, [&](const auto &e) {
+        return static_cast<std::uint32_t>(get(index, target(e, g)));
+    });
+
+    if (!out)
+        throw std::runtime_error(filename + ": write failed");
+}
+
+/**
+ * Write a weighted graph, with the weights in the given map, which must be integers that fit in an int32_t, e.g.
+ *
+ *     write_mapped_graph(g, get(boost::edge_weight, g), "graph.bin");
+ */
+template<typename Graph, typename WeightMap>
+void write_mapped_graph(const Graph &g, WeightMap weight, const std::string &filename) {
+    static_assert(std::is_integral_v<typename boost::property_traits<WeightMap>::value_type>,
+                  "mapped graphs store int32_t weights: round floating point weights first.");
+
+    std::ofstream out{filename, std::ios::binary | std::ios::trunc};
+    if (!out)
+        throw std::runtime_error(filename + ": cannot open for writing");
+
+    const auto index = get(boost::vertex_index, g);
+    const auto by_index = detail::write_mapped_layout(out, g, true);
+    detail::write_mapped_arcs<std::uint32_t>(out, g, by_index, [&](const auto &e) {
+        return static_cast<std::uint32_t>(get(index, target(e, g)));
+    });
+    detail::pad_to(out, detail::mapped_align(static_cast<std::uint64_t>(out.tellp())));
+    detail::write_mapped_arcs<std::int32_t>(out, g, by_index, [&](const auto &e) {
+        try {
+            return checked_weight<std::int32_t>(get(weight, e));
+        } catch (const std::range_error &ex) {
+            throw std::range_error(filename + ": " + ex.what());
+        }
+    });
+
+    if (!out)
+        throw std::runtime_error(filename + ": write failed");
+}
@@ -0,0 +1,100 @@
+/**
+ * read_edges.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Reading graphs from edge list and DOT files in parallel, compared to reading them with operator>>.
+ */
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/graphviz.hpp>
+
+#include "graph_common.h"
+#include "graph_builder.h"
+#include "edge_reader.h"
+
+int main() {
+    constexpr std::size_t v = 1000000;
+    constexpr std::size_t e = 5000000;
+
+    // Write a random edge list, with weights.
+    {
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+        std::uniform_int_distribution<int> wdist(1, 100);
+        std::ofstream out{"edges.txt"};
+        out << "# A random graph on " << v << " vertices\n";
+        for (std::size_t i = 0; i < e; ++i)
+            out << vdist(gen) << ' ' << vdist(gen) << ' ' << wdist(gen) << '\n';
+    }
+
+    // The iostream way.
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    {
+        const auto start = std::chrono::steady_clock::now();
+        std::ifstream in{"edges.txt"};
+        std::string comment;
+        std::getline(in, comment);
+        std::size_t s, t;
+        int w;
+        while (in >> s >> t >> w)
+            edges.emplace_back(s, t);
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "operator>>: " << elapsed.count() << " ms" << std::endl;
+    }
+    const auto expected = build_graph(edges.begin(), edges.end(), v);
+
+    // The parallel reader, straight into the bulk builder.
+    const auto parsed = read_edge_file("edges.txt");
+    std::cout << "read_edge_file: " << parsed.seconds * 1000 << " ms, " << parsed.megabytes_per_second() << " MB/s, "
+              << parsed.num_edges() << " edges in " << parsed.edges.size() << " chunks" << std::endl;
+    const auto g = build_graph(parsed);
+    std::cout << "Same graph: " << std::boolalpha
+              << (boost::num_vertices(g) == boost::num_vertices(expected)
+                  && boost::num_edges(g) == boost::num_edges(expected)) << std::endl;
+
+    // The CSR graph, read with the weights.
+    const auto weighted = read_edge_file("edges.txt", {edge_format::detect, edge_form::symmetric, 0, 1 << 20, true});
+    const auto wg = build_weighted_csr(weighted);
+    std::cout << "Weighted CSR arcs: " << boost::num_edges(wg) << std::endl;
+
+    // A round trip through DOT, as written by play_props.
+    {
+        std::array<int, 10> weights{1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        const auto cn = createCn_weighted(weights);
+        std::ofstream out{"cycle.dot"};
+        boost::write_graphviz(out, cn, boost::default_writer{}, [&cn](std::ostream &os, const auto &edge) {
+            os << "[weight=" << boost::get(boost::edge_weight, cn, edge) << "]";
+        });
+    }
+    const auto dot = read_edge_file("cycle.dot", {edge_format::detect, edge_form::as_read, 0, 1 << 20, true});
+    std::cout << "cycle.dot:";
+    for (std::size_t i = 0; i < dot.edges[0].size(); ++i)
+        std::cout << " " << dot.edges[0][i].first << "-" << dot.edges[0][i].second << ":" << dot.weights[0][i];
+    std::cout << std::endl;
+
+    // Only an attribute named exactly weight is a weight.
+    {
+        const auto parsed = read_edges("graph {\n0 -- 1 [label=\"weight 3\", lineweight=2];\n1 -- 2 [color=red weight=4];\n}\n",
+                                       {edge_format::dot, edge_form::as_read, 1, 1 << 20, true});
+        std::cout << "Attribute weights: " << parsed.weights[0][0] << " " << parsed.weights[0][1] << std::endl;
+    }
+
+    // Mistakes are reported with their position.
+    try {
+        read_edges("0 1\n1 2\n2 x\n");
+    } catch (const std::runtime_error &ex) {
+        std::cout << "Error: " << ex.what() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * reorder.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Relabelling the vertices of a scrambled grid for locality, and translating the results back.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/bandwidth.hpp>
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/visitors.hpp>
+
+#include "graph_common.h"
+#include "vertex_reorder.h"
+
+/** BFS distances from s in a CSR graph. **/
+std::vector<int> bfs_distances(const csr_graph_t &g, const std::size_t s) {
+    std::vector<int> distances(boost::num_vertices(g), 0);
+    boost::breadth_first_search(g, s,
+            boost::visitor(boost::make_bfs_visitor(boost::record_distances(distances.data(), boost::on_tree_edge{}))));
+    return distances;
+}
+
+int main() {
+    // A W x H grid whose vertex ids have been shuffled, as they would be in a file from the wild.
+    constexpr std::size_t W = 700;
+    constexpr std::size_t H = 700;
+    constexpr std::size_t n = W * H;
+    std::mt19937 gen(0);
+    std::vector<std::size_t> id(n);
+    std::iota(id.begin(), id.end(), 0);
+    std::shuffle(id.begin(), id.end(), gen);
+
+    std::vector<std::pair<std::size_t, std::size_t>> edges;
+    for (std::size_t y = 0; y < H; ++y)
+        for (std::size_t x = 0; x < W; ++x) {
+            if (x + 1 < W) edges.emplace_back(id[y * W + x], id[y * W + x + 1]);
+            if (y + 1 < H) edges.emplace_back(id[y * W + x], id[(y + 1) * W + x]);
+        }
+
+    const auto g = make_csr(edges.begin(), edges.end(), n);
+    const std::size_t s = id[(H / 2) * W + W / 2];
+    const auto expected = bfs_distances(g, s);
+
+    // Times ten BFS runs on a graph, from the vertex that was originally s.
+    const auto time_bfs = [](const csr_graph_t &h, const std::size_t source) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 10; ++i)
+            bfs_distances(h, source);
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    };
+
+    std::cout << "original: bandwidth " << boost::bandwidth(g) << ", 10 BFS in " << time_bfs(g, s) << " ms"
+              << std::endl;
+
+    const std::pair<const char *, vertex_order> orders[] = {
+            {"rcm", vertex_order::reverse_cuthill_mckee},
+            {"degree", vertex_order::degree},
+            {"bfs", vertex_order::bfs}
+    };
+    for (const auto &[name, order]: orders) {
+        const auto p = vertex_ordering(g, order);
+        const auto h = reorder(g, p);
+        const auto same = restore(bfs_distances(h, p.to_new[s]), p) == expected;
+        std::cout << name << ": bandwidth " << boost::bandwidth(h) << ", 10 BFS in " << time_bfs(h, p.to_new[s])
+                  << " ms, same distances: " << std::boolalpha << same << std::endl;
+    }
+
+    // The adjacency list version, with weights carried over, and predecessors translated back.
+    {
+        std::uniform_int_distribution<int> wdist(1, 10);
+        std::vector<int> weights;
+        for (std::size_t i = 0; i < edges.size(); ++i)
+            weights.emplace_back(wdist(gen));
+        const weighted_graph_t wg(edges.begin(), edges.end(), weights.begin(), n);
+
+        std::vector<int> distances(n);
+        boost::dijkstra_shortest_paths(wg, s, boost::distance_map(
+                boost::make_iterator_property_map(distances.begin(), boost::get(boost::vertex_index, wg))));
+
+        const auto p = vertex_ordering(wg, vertex_order::reverse_cuthill_mckee);
+        const auto wh = reorder(wg, p);
+        std::vector<int> reordered_distances(n);
+        std::vector<std::size_t> reordered_directions(n);
+        boost::dijkstra_shortest_paths(wh, p.to_new[s],
+                boost::predecessor_map(
+                        boost::make_iterator_property_map(reordered_directions.begin(), boost::get(boost::vertex_index, wh)))
+                .distance_map(
+                        boost::make_iterator_property_map(reordered_distances.begin(), boost::get(boost::vertex_index, wh))));
+        const auto directions = restore_vertices(reordered_directions, p);
+
+        // Every predecessor must be a neighbour lying on a shortest path.
+        bool valid = true;
+        for (std::size_t v = 0; v < n; ++v)
+            if (v != s) {
+                const auto [e, found] = boost::edge(directions[v], v, wg);
+                valid = valid && found && distances[directions[v]] + boost::get(boost::edge_weight, wg, e) == distances[v];
+            }
+        std::cout << "weighted rcm: same distances: " << (restore(reordered_distances, p) == distances)
+                  << ", valid predecessors: " << valid << std::endl;
+    }
+
+    return 0;
+}
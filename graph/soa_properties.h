@@ -0,0 +1,121 @@
+/**
+ * soa_properties.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Structure-of-arrays storage for vertex and edge properties.
+ *
+ * Bundled properties (like VertexInfo and EdgeInfo in play_props.cpp) are stored as one struct per vertex or edge,
+ * right inside the adjacency list. That's convenient, but an algorithm that only needs one field still drags the
+ * whole struct through the cache: a Dijkstra that reads only weights also loads every string and flag next to
+ * them.
+ *
+ * A property_columns object keeps each field in its own contiguous vector instead, indexed by vertex or edge
+ * index, and hands out a property map per column, so the algorithms can be pointed at exactly the data they need.
+ * Columns are picked by position, which reads best with an enum naming them:
+ *
+ *     enum edge_field { weight, carved, wrapped };
+ *     csr_graph_t g = make_csr(...);
+ *     auto edge_props = make_edge_columns<int, char, char>(g);
+ *     dijkstra_shortest_paths(g, 0, predecessor_map(p).weight_map(edge_props.map<weight>()));
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/property_map/property_map.hpp>
+
+namespace detail {
+    // Unqualified, so that ADL finds get for index maps that live outside boost, like the CSR edge index map.
+    template<typename IndexMap, typename Key>
+    std::size_t column_index(const IndexMap &index, const Key &k) {
+        using boost::get;
+        return get(index, k);
+    }
+}
+
+/**
+ * Columns of properties for the keys (vertices or edges) of a graph, one vector per column.
+ * IndexMap maps each key to its position 0..n-1 in the columns.
+ */
+template<typename Key, typename IndexMap, typename... Columns>
+class property_columns {
+    static_assert(!std::disjunction_v<std::is_same<Columns, bool>...>,
+                  "std::vector<bool> is not contiguous and has no real references: use char for flags.");
+
+public:
+    template<std::size_t I>
+    using column_type = std::tuple_element_t<I, std::tuple<Columns...>>;
+
+    template<std::size_t I>
+    using map_type = boost::iterator_property_map<typename std::vector<column_type<I>>::iterator,
+            IndexMap, column_type<I>, column_type<I>&>;
+
+    property_columns(const std::size_t n, IndexMap index) : index_{index} {
+        resize(n);
+    }
+
+    /** Grow (or shrink) every column to n entries, e.g. after adding vertices or edges. **/
+    void resize(const std::size_t n) {
+        std::apply([n](auto &... column) { (column.resize(n), ...); }, columns_);
+    }
+
+    std::size_t size() const { return std::get<0>(columns_).size(); }
+
+    /** The whole of column I, for sweeps that don't need to go through the graph. **/
+    template<std::size_t I>
+    std::vector<column_type<I>> &column() { return std::get<I>(columns_); }
+
+    template<std::size_t I>
+    const std::vector<column_type<I>> &column() const { return std::get<I>(columns_); }
+
+    /** Column I as a read/write property map, for passing to the Boost algorithms. **/
+    template<std::size_t I>
+    map_type<I> map() { return map_type<I>{std::get<I>(columns_).begin(), index_}; }
+
+    /** Direct access to column I of key k. **/
+    template<std::size_t I>
+    column_type<I> &get(const Key &k) { return std::get<I>(columns_)[detail::column_index(index_, k)]; }
+
+    template<std::size_t I>
+    const column_type<I> &get(const Key &k) const { return std::get<I>(columns_)[detail::column_index(index_, k)]; }
+
+private:
+    IndexMap index_;
+    std::tuple<std::vector<Columns>...> columns_;
+};
+
+/** Columns indexed by the vertices of a graph. **/
+template<typename Graph, typename... Columns>
+using vertex_columns = property_columns<typename boost::graph_traits<Graph>::vertex_descriptor,
+        typename boost::property_map<Graph, boost::vertex_index_t>::const_type, Columns...>;
+
+/**
+ * Columns indexed by the edges of a graph.
+ * The edge index should be intrinsic to the edge descriptor, as it is in a CSR graph (where it is the position of
+ * the edge in the target array): then a column lookup is a single read. An adjacency list's edge_index is an
+ * interior property stored with each edge, so every lookup first chases the edge's property pointer, and the
+ * columns end up slower than bundled properties.
+ */
+template<typename Graph, typename... Columns>
+using edge_columns = property_columns<typename boost::graph_traits<Graph>::edge_descriptor,
+        typename boost::property_map<Graph, boost::edge_index_t>::const_type, Columns...>;
+
+/** Make vertex columns sized for the vertices of g. **/
+template<typename... Columns, typename Graph>
+vertex_columns<Graph, Columns...> make_vertex_columns(const Graph &g) {
+    return {boost::num_vertices(g), boost::get(boost::vertex_index, g)};
+}
+
+/** Make edge columns sized for the edges of g, which must have an edge_index property, e.g. a CSR graph. **/
+template<typename... Columns, typename Graph>
+edge_columns<Graph, Columns...> make_edge_columns(const Graph &g) {
+    return {boost::num_edges(g), boost::get(boost::edge_index, g)};
+}
@@ -0,0 +1,143 @@
+/**
+ * soa_props.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * The toroidal maze from play_props, with its properties stored column by column instead of struct by struct.
+ * The graph is a CSR graph, whose edge index is intrinsic, so each column is read with a single array access.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/named_function_params.hpp>
+
+#include "graph_common.h"
+#include "soa_properties.h"
+
+// The fields of VertexInfo and EdgeInfo, now column numbers.
+enum vertex_field { vertexIdx, visited, essential };
+enum edge_field { weight, carved, wrapped };
+
+int main() {
+    constexpr int W = 10;
+    constexpr int H = 5;
+
+    const auto ranker = [&](int x, int y) {
+        return ((y % H + H) % H) * W + ((x % W + W) % W);
+    };
+
+    std::vector<std::pair<int, int>> deltas;
+    for (const auto dx: {-1, 0, 1})
+        for (const auto dy: {-1, 0, 1})
+            if (dx != 0 || dy != 0)
+                deltas.emplace_back(dx, dy);
+
+    // The columns are keyed on the CSR graph's edge index, which is just the position of the edge in its target
+    // array, so first the structure, then the properties. Each cell's eight moves are arcs out of it.
+    std::vector<std::pair<int, int>> moves;
+    for (auto y = 0; y < H; ++y)
+        for (auto x = 0; x < W; ++x)
+            for (const auto &[dx, dy]: deltas)
+                moves.emplace_back(ranker(x, y), ranker(x + dx, y + dy));
+    const csr_graph_t g{boost::edges_are_unsorted_multi_pass, moves.begin(), moves.end(), W * H};
+
+    auto vprops = make_vertex_columns<int, char, char>(g);
+    for (auto y = 0; y < H; ++y)
+        for (auto x = 0; x < W; ++x) {
+            const auto v = ranker(x, y);
+            vprops.get<vertexIdx>(v) = v;
+            vprops.get<essential>(v) = x == 0 || y == 0;
+        }
+
+    auto eprops = make_edge_columns<int, char, char>(g);
+    std::fill(eprops.column<weight>().begin(), eprops.column<weight>().end(), 1);
+
+    // The same weight changes as in play_props (but skipping v1 % 0). A move wraps if it jumps more than one cell.
+    for (auto [eit, eend] = boost::edges(g); eit != eend; ++eit) {
+        const auto v1 = boost::source(*eit, g);
+        const auto v2 = boost::target(*eit, g);
+        const auto dx = static_cast<int>(v1 % W) - static_cast<int>(v2 % W);
+        const auto dy = static_cast<int>(v1 / W) - static_cast<int>(v2 / W);
+        eprops.get<wrapped>(*eit) = dx < -1 || dx > 1 || dy < -1 || dy > 1;
+        if ((v1 + v2) % 2 == 0 && v2 != 0) {
+            eprops.get<carved>(*eit) = true;
+            eprops.get<weight>(*eit) += v1 % v2;
+        }
+    }
+
+    // Dijkstra only sees the weight column.
+    std::vector<std::size_t> directions(W * H);
+    boost::dijkstra_shortest_paths(g, 0, boost::predecessor_map(
+            boost::make_iterator_property_map(directions.begin(), boost::get(boost::vertex_index, g)))
+            .weight_map(eprops.map<weight>()));
+
+    // Mark the path to the centre as visited: this sweep only touches the visited column.
+    for (std::size_t v = ranker(W / 2, H / 2); v != 0; v = directions[v])
+        vprops.get<visited>(v) = true;
+    for (auto y = 0; y < H; ++y) {
+        for (auto x = 0; x < W; ++x)
+            std::cout << (vprops.get<visited>(ranker(x, y)) ? '*' : vprops.get<essential>(ranker(x, y)) ? '#' : '.');
+        std::cout << std::endl;
+    }
+
+    // On a bigger graph, compare a weight-only Dijkstra over bundled properties, with a string next to every
+    // weight as in dijkstra_userdef, and over a weight column. Both are CSR graphs with the same arcs, so the only
+    // difference is whether the weights are interleaved with the strings or packed on their own.
+    {
+        struct edge_properties {
+            double weight;
+            std::string ecolour;
+        };
+        using bundled_graph = boost::compressed_sparse_row_graph<boost::directedS, boost::no_property, edge_properties>;
+
+        constexpr std::size_t v = 200000;
+        constexpr std::size_t e = 1000000;
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<std::size_t> vdist(0, v - 1);
+        std::uniform_real_distribution<double> unif(0, 100);
+
+        // Undirected, so every edge is stored in both directions, as in make_csr.
+        std::vector<std::pair<std::size_t, std::size_t>> arcs;
+        std::vector<edge_properties> props;
+        for (std::size_t i = 0; i < e; ++i) {
+            const auto s = vdist(gen), t = vdist(gen);
+            const edge_properties p{unif(gen), "a colour too long for small string optimization"};
+            arcs.emplace_back(s, t);
+            arcs.emplace_back(t, s);
+            props.push_back(p);
+            props.push_back(p);
+        }
+        const bundled_graph bg{boost::edges_are_unsorted_multi_pass, arcs.begin(), arcs.end(), props.begin(), v};
+        const csr_graph_t cg{boost::edges_are_unsorted_multi_pass, arcs.begin(), arcs.end(), v};
+
+        // Both constructors sort the arcs the same way, so edge i of one is edge i of the other.
+        auto columns = make_edge_columns<double>(cg);
+        for (auto [eit, eend] = boost::edges(bg); eit != eend; ++eit)
+            columns.column<0>()[boost::get(boost::edge_index, bg, *eit)] = bg[*eit].weight;
+
+        std::vector<double> d1(v), d2(v);
+        auto start = std::chrono::steady_clock::now();
+        boost::dijkstra_shortest_paths(bg, 0, boost::distance_map(
+                boost::make_iterator_property_map(d1.begin(), boost::get(boost::vertex_index, bg)))
+                .weight_map(boost::get(&edge_properties::weight, bg)));
+        const std::chrono::duration<double, std::milli> bundled = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        boost::dijkstra_shortest_paths(cg, 0, boost::distance_map(
+                boost::make_iterator_property_map(d2.begin(), boost::get(boost::vertex_index, cg)))
+                .weight_map(columns.map<0>()));
+        const std::chrono::duration<double, std::milli> columnar = std::chrono::steady_clock::now() - start;
+
+        std::cout << "Bundled: " << bundled.count() << " ms, columns: " << columnar.count()
+                  << " ms, same distances: " << std::boolalpha << (d1 == d2) << std::endl;
+    }
+
+    return 0;
+}
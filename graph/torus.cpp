@@ -0,0 +1,78 @@
+/**
+ * torus.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Searching an implicit toroidal grid that never stores its edges.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+// The torus has to come before the algorithms.
+#include "torus_graph.h"
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/visitors.hpp>
+#include <boost/property_map/function_property_map.hpp>
+
+int main() {
+    // The maze from play_props: 10 x 5, 8 neighbours, wrapping around.
+    constexpr int W = 10;
+    constexpr int H = 5;
+    const torus_graph g{W, H};
+    std::cout << "Vertices: " << boost::num_vertices(g) << ", edges: " << boost::num_edges(g)
+              << ", size of the graph: " << sizeof(g) << " bytes" << std::endl;
+
+    // Carve the edges whose ends add up to an even number, as play_props does, but into a bitset.
+    auto carved = make_edge_bitset(g);
+    std::size_t wrapped = 0;
+    for (auto [eit, eend] = boost::edges(g); eit != eend; ++eit) {
+        if ((boost::source(*eit, g) + boost::target(*eit, g)) % 2 == 0)
+            boost::put(carved, *eit, true);
+        wrapped += g.wrapped(*eit);
+    }
+    std::cout << "Carved: " << carved.count() << ", wrapped: " << wrapped << std::endl;
+
+    // Breadth-first search works just as it does on an adjacency_list.
+    std::vector<int> distances(boost::num_vertices(g), 0);
+    boost::breadth_first_search(g, g.rank(0, 0),
+        boost::visitor(
+                boost::make_bfs_visitor(
+                        boost::record_distances(distances.data(), boost::on_tree_edge{}))));
+    for (auto y = 0; y < H; ++y) {
+        for (auto x = 0; x < W; ++x)
+            std::cout << distances[g.rank(x, y)] << " ";
+        std::cout << std::endl;
+    }
+
+    // Dijkstra over the carved edges only: uncarved edges get a huge weight.
+    std::vector<std::size_t> directions(boost::num_vertices(g));
+    const auto weight = boost::make_function_property_map<torus_edge>(
+            [&](const torus_edge &e) { return carved.test(e) ? 1 : 1000; });
+    boost::dijkstra_shortest_paths(g, 0, boost::predecessor_map(directions.data()).weight_map(weight));
+    std::cout << "Path from (5, 2) back to (0, 0):";
+    for (auto v = g.rank(5, 2); v != 0; v = directions[v])
+        std::cout << " (" << g.x(v) << ", " << g.y(v) << ")";
+    std::cout << " (0, 0)" << std::endl;
+
+    // A big grid: storing its 32 million edges would take gigabytes, but the only memory here is the distances.
+    {
+        const torus_graph big{4000, 2000};
+        std::vector<int> big_distances(boost::num_vertices(big), 0);
+        const auto start = std::chrono::steady_clock::now();
+        boost::breadth_first_search(big, 0,
+            boost::visitor(
+                    boost::make_bfs_visitor(
+                            boost::record_distances(big_distances.data(), boost::on_tree_edge{}))));
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "BFS over " << boost::num_edges(big) << " edges: " << elapsed.count() << " ms, farthest vertex at "
+                  << *std::max_element(big_distances.begin(), big_distances.end()) << std::endl;
+    }
+
+    return 0;
+}
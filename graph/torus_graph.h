@@ -0,0 +1,340 @@
+/**
+ * torus_graph.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * An implicit W x H grid graph, optionally wrapping around into a torus, with 4 or 8 neighbours per cell.
+ *
+ * play_props.cpp builds its toroidal maze by adding every vertex and every edge to an adjacency_list, but the
+ * structure of a grid is completely regular: the neighbours of (x, y) are just (x + dx, y + dy), wrapped around
+ * the edges. A torus_graph stores nothing but W, H and the neighbourhood, and computes vertices, edges and
+ * neighbours arithmetically, so a 10000 x 10000 grid costs a few bytes instead of hundreds of millions of edges.
+ *
+ * It models the Boost.Graph VertexListGraph, EdgeListGraph, IncidenceGraph and AdjacencyGraph concepts, so
+ * breadth_first_search, dijkstra_shortest_paths and friends work on it directly. Vertices are the row-major
+ * indices y * W + x, exactly like ranker in play_props. Each edge has an index in [0, max_edge_index()), which is
+ * the edge_index property, so per-edge state can be kept outside the graph, in an edge_bitset (for flags like
+ * carved) or in property_columns.
+ *
+ * The free functions are declared in the global namespace and brought into boost, so both unqualified (as in the
+ * Boost algorithms) and boost::-qualified calls find them. Include this header before the algorithms using it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/graph/adjacency_iterator.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/filter_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+#include <boost/property_map/property_map.hpp>
+
+/** An edge of a torus_graph: the vertex it was reached from, and the direction taken. **/
+struct torus_edge {
+    std::size_t source;
+    std::uint8_t direction;
+};
+
+class torus_graph;
+
+namespace detail {
+    /** The neighbour offsets. Direction i and direction (k - 1 - i) are opposites. **/
+    constexpr int torus_dx8[] = {-1, -1, -1, 0, 0, 1, 1, 1};
+    constexpr int torus_dy8[] = {-1, 0, 1, -1, 1, -1, 0, 1};
+    constexpr int torus_dx4[] = {-1, 0, 0, 1};
+    constexpr int torus_dy4[] = {0, -1, 1, 0};
+
+    /** Iterates over the out-edges of one vertex, skipping directions that leave a non-wrapping grid. **/
+    class torus_out_edge_iterator : public boost::iterator_facade<torus_out_edge_iterator, torus_edge,
+            std::forward_iterator_tag, torus_edge> {
+    public:
+        torus_out_edge_iterator() = default;
+        torus_out_edge_iterator(const torus_graph *g, const std::size_t v, const std::uint8_t d)
+                : g_{g}, v_{v}, d_{d} { skip(); }
+
+    private:
+        friend class boost::iterator_core_access;
+
+        torus_edge dereference() const { return {v_, d_}; }
+        bool equal(const torus_out_edge_iterator &other) const { return v_ == other.v_ && d_ == other.d_; }
+        void increment() { ++d_; skip(); }
+        inline void skip();
+
+        const torus_graph *g_ = nullptr;
+        std::size_t v_ = 0;
+        std::uint8_t d_ = 0;
+    };
+}
+
+class torus_graph {
+public:
+    // The Boost.Graph traits.
+    using vertex_descriptor = std::size_t;
+    using edge_descriptor = torus_edge;
+    using directed_category = boost::undirected_tag;
+    using edge_parallel_category = boost::disallow_parallel_edge_tag;
+    struct traversal_category : boost::vertex_list_graph_tag, boost::edge_list_graph_tag,
+                                boost::incidence_graph_tag, boost::adjacency_graph_tag {};
+
+    using vertices_size_type = std::size_t;
+    using edges_size_type = std::size_t;
+    using degree_size_type = std::size_t;
+
+    using vertex_iterator = boost::counting_iterator<std::size_t>;
+    using out_edge_iterator = detail::torus_out_edge_iterator;
+    using adjacency_iterator = typename boost::adjacency_iterator_generator<torus_graph,
+            vertex_descriptor, out_edge_iterator>::type;
+
+    /** Turns an edge index back into an edge. Indices of edges that don't exist are never produced. **/
+    struct edge_from_index {
+        const torus_graph *g;
+        torus_edge operator()(const std::size_t i) const { return {i / g->half(), static_cast<std::uint8_t>(i % g->half())}; }
+    };
+    struct edge_exists {
+        const torus_graph *g;
+        bool operator()(const std::size_t i) const { return g->valid(i / g->half(), i % g->half()); }
+    };
+    using edge_iterator = boost::transform_iterator<edge_from_index,
+            boost::filter_iterator<edge_exists, boost::counting_iterator<std::size_t>>, torus_edge, torus_edge>;
+
+    static vertex_descriptor null_vertex() { return static_cast<std::size_t>(-1); }
+
+    /**
+     * A W x H grid. If wrap is set, it's a torus. neighbours is 4 (left, right, up and down) or 8 (including the
+     * diagonals). A torus needs W, H >= 3, so that no two directions lead to the same neighbour: otherwise, or
+     * with any other number of neighbours, this throws std::invalid_argument.
+     */
+    torus_graph(const std::size_t width, const std::size_t height, const bool wrap = true, const int neighbours = 8)
+            : width_{width}, height_{height}, wrap_{wrap}, k_{static_cast<std::uint8_t>(neighbours)},
+              dx_{neighbours == 8 ? detail::torus_dx8 : detail::torus_dx4},
+              dy_{neighbours == 8 ? detail::torus_dy8 : detail::torus_dy4} {
+        if (neighbours != 4 && neighbours != 8)
+            throw std::invalid_argument("a torus_graph has 4 or 8 neighbours per cell");
+        if (wrap && (width < 3 || height < 3))
+            throw std::invalid_argument("a wrapping torus_graph needs a width and height of at least 3");
+
+        // Every vertex of a torus has k neighbours. A flat grid has W - 1 horizontal edges per row, H - 1 vertical
+        // edges per column, and with diagonals, two per inner square.
+        if (wrap)
+            num_edges_ = num_vertices() * half();
+        else if (width > 0 && height > 0) {
+            num_edges_ = height * (width - 1) + width * (height - 1);
+            if (neighbours == 8)
+                num_edges_ += 2 * (width - 1) * (height - 1);
+        }
+    }
+
+    std::size_t width() const { return width_; }
+    std::size_t height() const { return height_; }
+    bool wraps() const { return wrap_; }
+    std::size_t num_vertices() const { return width_ * height_; }
+    std::size_t num_edges() const { return num_edges_; }
+    std::size_t neighbours() const { return k_; }
+
+    /** Edge indices lie in [0, max_edge_index()). On a torus, every index is used. **/
+    std::size_t max_edge_index() const { return num_vertices() * half(); }
+
+    /** The vertex at (x, y), wrapping coordinates around, e.g. rank(-1, 0) == rank(W - 1, 0). **/
+    vertex_descriptor rank(const long x, const long y) const {
+        const long w = width_, h = height_;
+        return static_cast<std::size_t>(((y % h + h) % h) * w + ((x % w + w) % w));
+    }
+
+    std::size_t x(const vertex_descriptor v) const { return v % width_; }
+    std::size_t y(const vertex_descriptor v) const { return v / width_; }
+
+    vertex_descriptor target(const torus_edge &e) const {
+        return rank(static_cast<long>(x(e.source)) + dx_[e.direction], static_cast<long>(y(e.source)) + dy_[e.direction]);
+    }
+
+    /** Whether the edge crosses the boundary of the grid, i.e. uses the wrap-around of the torus. **/
+    bool wrapped(const torus_edge &e) const {
+        const long nx = static_cast<long>(x(e.source)) + dx_[e.direction];
+        const long ny = static_cast<long>(y(e.source)) + dy_[e.direction];
+        return nx < 0 || ny < 0 || nx >= static_cast<long>(width_) || ny >= static_cast<long>(height_);
+    }
+
+    /** Whether direction d from v leads to another vertex, i.e. the graph wraps, or it stays inside the grid. **/
+    bool valid(const vertex_descriptor v, const std::size_t d) const {
+        return wrap_ || !wrapped({v, static_cast<std::uint8_t>(d)});
+    }
+
+    /** The same undirected edge always gets the same index, whichever end it is seen from. **/
+    std::size_t edge_index(const torus_edge &e) const {
+        return e.direction < half()
+               ? e.source * half() + e.direction
+               : target(e) * half() + (k_ - 1 - e.direction);
+    }
+
+    std::size_t degree(const vertex_descriptor v) const {
+        if (wrap_)
+            return k_;
+        std::size_t result = 0;
+        for (std::uint8_t d = 0; d < k_; ++d)
+            result += valid(v, d);
+        return result;
+    }
+
+    std::uint8_t half() const { return k_ / 2; }
+    std::uint8_t directions() const { return k_; }
+
+private:
+    std::size_t width_;
+    std::size_t height_;
+    bool wrap_;
+    std::uint8_t k_;
+    const int *dx_;
+    const int *dy_;
+    std::size_t num_edges_ = 0;
+};
+
+void detail::torus_out_edge_iterator::skip() {
+    while (d_ < g_->directions() && !g_->valid(v_, d_))
+        ++d_;
+}
+
+// Two descriptors are the same edge if they are the same undirected edge, seen from either end. This needs the
+// graph, so we settle for comparing edges seen from the same end, which is all the Boost algorithms need.
+inline bool operator==(const torus_edge &a, const torus_edge &b) {
+    return a.source == b.source && a.direction == b.direction;
+}
+inline bool operator!=(const torus_edge &a, const torus_edge &b) { return !(a == b); }
+
+// The Boost.Graph interface.
+
+inline std::pair<torus_graph::vertex_iterator, torus_graph::vertex_iterator> vertices(const torus_graph &g) {
+    return {torus_graph::vertex_iterator{0}, torus_graph::vertex_iterator{g.num_vertices()}};
+}
+
+inline std::size_t num_vertices(const torus_graph &g) { return g.num_vertices(); }
+
+inline std::pair<torus_graph::edge_iterator, torus_graph::edge_iterator> edges(const torus_graph &g) {
+    using counting = boost::counting_iterator<std::size_t>;
+    const torus_graph::edge_exists exists{&g};
+    const torus_graph::edge_from_index to_edge{&g};
+    const auto first = boost::make_filter_iterator(exists, counting{0}, counting{g.max_edge_index()});
+    const auto last = boost::make_filter_iterator(exists, counting{g.max_edge_index()}, counting{g.max_edge_index()});
+    return {torus_graph::edge_iterator{first, to_edge}, torus_graph::edge_iterator{last, to_edge}};
+}
+
+inline std::size_t num_edges(const torus_graph &g) { return g.num_edges(); }
+
+inline std::size_t source(const torus_edge &e, const torus_graph &) { return e.source; }
+
+inline std::size_t target(const torus_edge &e, const torus_graph &g) { return g.target(e); }
+
+inline std::pair<torus_graph::out_edge_iterator, torus_graph::out_edge_iterator>
+out_edges(const std::size_t v, const torus_graph &g) {
+    return {torus_graph::out_edge_iterator{&g, v, 0}, torus_graph::out_edge_iterator{&g, v, g.directions()}};
+}
+
+inline std::size_t out_degree(const std::size_t v, const torus_graph &g) { return g.degree(v); }
+
+inline std::size_t degree(const std::size_t v, const torus_graph &g) { return g.degree(v); }
+
+inline std::pair<torus_graph::adjacency_iterator, torus_graph::adjacency_iterator>
+adjacent_vertices(const std::size_t v, const torus_graph &g) {
+    const auto [first, last] = out_edges(v, g);
+    return {torus_graph::adjacency_iterator{first, &g}, torus_graph::adjacency_iterator{last, &g}};
+}
+
+inline std::size_t vertex(const std::size_t i, const torus_graph &) { return i; }
+
+/** The edge_index property of a torus_graph. **/
+class torus_edge_index_map : public boost::put_get_helper<std::size_t, torus_edge_index_map> {
+public:
+    using key_type = torus_edge;
+    using value_type = std::size_t;
+    using reference = std::size_t;
+    using category = boost::readable_property_map_tag;
+
+    explicit torus_edge_index_map(const torus_graph &g) : g_{&g} {}
+
+    std::size_t operator[](const torus_edge &e) const { return g_->edge_index(e); }
+
+private:
+    const torus_graph *g_;
+};
+
+inline boost::typed_identity_property_map<std::size_t> get(boost::vertex_index_t, const torus_graph &) { return {}; }
+
+inline std::size_t get(boost::vertex_index_t, const torus_graph &, const std::size_t v) { return v; }
+
+inline torus_edge_index_map get(boost::edge_index_t, const torus_graph &g) { return torus_edge_index_map{g}; }
+
+inline std::size_t get(boost::edge_index_t, const torus_graph &g, const torus_edge &e) { return g.edge_index(e); }
+
+/**
+ * One bit of state per edge of a graph with an edge_index property, e.g. the carved flag of a maze: an eighth of a
+ * byte per edge instead of a bool in a struct. It is a read/write property map.
+ */
+template<typename EdgeIndexMap>
+class edge_bitset {
+public:
+    using key_type = typename boost::property_traits<EdgeIndexMap>::key_type;
+    using value_type = bool;
+    using reference = bool;
+    using category = boost::read_write_property_map_tag;
+
+    edge_bitset(const std::size_t max_index, EdgeIndexMap index) : bits_{max_index}, index_{index} {}
+
+    bool test(const key_type &e) const { return bits_.test(boost::get(index_, e)); }
+    void set(const key_type &e, const bool value = true) { bits_.set(boost::get(index_, e), value); }
+    std::size_t count() const { return bits_.count(); }
+
+private:
+    boost::dynamic_bitset<> bits_;
+    EdgeIndexMap index_;
+};
+
+template<typename EdgeIndexMap>
+bool get(const edge_bitset<EdgeIndexMap> &m, const typename edge_bitset<EdgeIndexMap>::key_type &e) {
+    return m.test(e);
+}
+
+template<typename EdgeIndexMap>
+void put(edge_bitset<EdgeIndexMap> &m, const typename edge_bitset<EdgeIndexMap>::key_type &e, const bool value) {
+    m.set(e, value);
+}
+
+/** An edge_bitset covering every edge of a torus_graph. **/
+inline edge_bitset<torus_edge_index_map> make_edge_bitset(const torus_graph &g) {
+    return {g.max_edge_index(), torus_edge_index_map{g}};
+}
+
+namespace boost {
+    template<>
+    struct property_map<torus_graph, vertex_index_t> {
+        using type = typed_identity_property_map<std::size_t>;
+        using const_type = type;
+    };
+
+    template<>
+    struct property_map<torus_graph, edge_index_t> {
+        using type = torus_edge_index_map;
+        using const_type = type;
+    };
+
+    using ::vertices;
+    using ::num_vertices;
+    using ::edges;
+    using ::num_edges;
+    using ::source;
+    using ::target;
+    using ::out_edges;
+    using ::out_degree;
+    using ::degree;
+    using ::adjacent_vertices;
+    using ::vertex;
+    using ::get;
+    using ::put;
+}
@@ -0,0 +1,211 @@
+/**
+ * vertex_reorder.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Relabelling the vertices of a graph for locality.
+ *
+ * The vertex ids of a graph are whatever order the vertices were created in: insertion order in createCn_*,
+ * row-major order in play_props.cpp's ranker, or file order for real-world data. A traversal that visits v and then
+ * its neighbours jumps all over the distance, predecessor and colour arrays if those neighbours have distant ids.
+ *
+ * Renumbering the vertices so that neighbours get nearby ids fixes this without touching the algorithms. Three
+ * orderings are offered:
+ *
+ * 1. Reverse Cuthill-McKee, which does a BFS visiting low-degree vertices first, and then reverses the order. It
+ *    keeps the bandwidth (the largest id difference across an edge) small, and is usually the best choice for
+ *    meshes, grids and road networks.
+ *
+ * 2. Degree order, highest first, which packs the hubs of a power-law graph together at the front.
+ *
+ * 3. Plain BFS order, which is cheap and does well when traversals start near the same place.
+ *
+ * The result is a vertex_permutation, which is used to rebuild the graph and any external property maps, and to
+ * translate results computed on the reordered graph back to the original ids:
+ *
+ *     const auto p = vertex_ordering(g, vertex_order::reverse_cuthill_mckee);
+ *     const auto h = reorder(g, p);
+ *     ...run BFS on h from p.to_new[s] into distances...
+ *     const auto original_distances = restore(distances, p);
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/compressed_sparse_row_graph.hpp>
+#include <boost/graph/cuthill_mckee_ordering.hpp>
+#include <boost/graph/graph_traits.hpp>
+#include <boost/graph/properties.hpp>
+
+enum class vertex_order {
+    reverse_cuthill_mckee,
+    degree,
+    bfs
+};
+
+/** A relabelling of the vertices 0..n-1 of a graph, in both directions. **/
+struct vertex_permutation {
+    // to_new[v] is the new id of the vertex with old id v.
+    std::vector<std::size_t> to_new;
+
+    // to_old[v] is the old id of the vertex with new id v.
+    std::vector<std::size_t> to_old;
+
+    std::size_t size() const { return to_new.size(); }
+};
+
+/** Make a permutation from the list of old ids in their new order. **/
+vertex_permutation make_vertex_permutation(std::vector<std::size_t> to_old) {
+    std::vector<std::size_t> to_new(to_old.size());
+    for (std::size_t i = 0; i < to_old.size(); ++i)
+        to_new[to_old[i]] = i;
+    return {std::move(to_new), std::move(to_old)};
+}
+
+/**
+ * Compute a locality-improving order for the vertices of g, which must have a vertex_index property mapping
+ * vertices to 0..n-1. Disconnected graphs are handled one component at a time.
+ */
+template<typename Graph>
+vertex_permutation vertex_ordering(const Graph &g, const vertex_order order) {
+    using vertex = typename boost::graph_traits<Graph>::vertex_descriptor;
+    const auto index = boost::get(boost::vertex_index, g);
+    const std::size_t n = boost::num_vertices(g);
+    std::vector<std::size_t> to_old;
+    to_old.reserve(n);
+
+    switch (order) {
+        case vertex_order::reverse_cuthill_mckee: {
+            std::vector<vertex> ordered(n);
+            boost::cuthill_mckee_ordering(g, ordered.rbegin());
+            for (const auto v: ordered)
+                to_old.emplace_back(boost::get(index, v));
+            break;
+        }
+
+        case vertex_order::degree: {
+            std::vector<std::size_t> degree(n);
+            for (auto [vit, vend] = boost::vertices(g); vit != vend; ++vit)
+                degree[boost::get(index, *vit)] = boost::out_degree(*vit, g);
+            to_old.resize(n);
+            std::iota(to_old.begin(), to_old.end(), 0);
+            std::stable_sort(to_old.begin(), to_old.end(),
+                             [&degree](const std::size_t u, const std::size_t v) { return degree[u] > degree[v]; });
+            break;
+        }
+
+        case vertex_order::bfs: {
+            std::vector<vertex> by_index(n);
+            for (auto [vit, vend] = boost::vertices(g); vit != vend; ++vit)
+                by_index[boost::get(index, *vit)] = *vit;
+
+            // to_old doubles as the BFS queue: the vertices are numbered in the order they are discovered.
+            std::vector<char> seen(n, 0);
+            for (std::size_t root = 0; root < n; ++root) {
+                if (seen[root])
+                    continue;
+                seen[root] = 1;
+                to_old.emplace_back(root);
+                for (auto head = to_old.size() - 1; head < to_old.size(); ++head)
+                    for (auto [eit, eend] = boost::out_edges(by_index[to_old[head]], g); eit != eend; ++eit) {
+                        const std::size_t w = boost::get(index, boost::target(*eit, g));
+                        if (!seen[w]) {
+                            seen[w] = 1;
+                            to_old.emplace_back(w);
+                        }
+                    }
+            }
+            break;
+        }
+    }
+
+    return make_vertex_permutation(std::move(to_old));
+}
+
+/**
+ * Rebuild an adjacency list with vecS vertex storage under the permutation p. Vertex and edge properties are
+ * carried over to the relabelled vertices and edges.
+ */
+template<typename OutEdgeListS, typename DirectedS, typename VertexProperty, typename EdgeProperty,
+        typename GraphProperty, typename EdgeListS>
+boost::adjacency_list<OutEdgeListS, boost::vecS, DirectedS, VertexProperty, EdgeProperty, GraphProperty, EdgeListS>
+reorder(const boost::adjacency_list<OutEdgeListS, boost::vecS, DirectedS, VertexProperty, EdgeProperty,
+                                    GraphProperty, EdgeListS> &g,
+        const vertex_permutation &p) {
+    boost::adjacency_list<OutEdgeListS, boost::vecS, DirectedS, VertexProperty, EdgeProperty, GraphProperty,
+            EdgeListS> h(boost::num_vertices(g));
+
+    for (std::size_t v = 0; v < p.size(); ++v)
+        boost::put(boost::vertex_all, h, p.to_new[v], boost::get(boost::vertex_all, g, v));
+
+    // Adding the edges in the new order of their sources puts each out-edge list together in memory.
+    std::vector<std::pair<std::size_t, typename boost::graph_traits<decltype(h)>::edge_descriptor>> edges;
+    for (auto [eit, eend] = boost::edges(g); eit != eend; ++eit)
+        edges.emplace_back(p.to_new[boost::source(*eit, g)], *eit);
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const auto &e1, const auto &e2) { return e1.first < e2.first; });
+    for (const auto &[u, e]: edges)
+        boost::add_edge(u, p.to_new[boost::target(e, g)], boost::get(boost::edge_all, g, e), h);
+
+    return h;
+}
+
+/** Rebuild a CSR graph under the permutation p, carrying over its vertex and edge properties. **/
+template<typename DirectedS, typename VertexProperty, typename EdgeProperty, typename GraphProperty,
+        typename Vertex, typename EdgeIndex>
+boost::compressed_sparse_row_graph<DirectedS, VertexProperty, EdgeProperty, GraphProperty, Vertex, EdgeIndex>
+reorder(const boost::compressed_sparse_row_graph<DirectedS, VertexProperty, EdgeProperty, GraphProperty,
+                                                 Vertex, EdgeIndex> &g,
+        const vertex_permutation &p) {
+    using graph = boost::compressed_sparse_row_graph<DirectedS, VertexProperty, EdgeProperty, GraphProperty,
+            Vertex, EdgeIndex>;
+
+    std::vector<std::pair<Vertex, Vertex>> arcs;
+    std::vector<EdgeProperty> properties;
+    arcs.reserve(boost::num_edges(g));
+    properties.reserve(boost::num_edges(g));
+    for (auto [eit, eend] = boost::edges(g); eit != eend; ++eit) {
+        arcs.emplace_back(p.to_new[boost::source(*eit, g)], p.to_new[boost::target(*eit, g)]);
+        properties.emplace_back(boost::get(boost::edge_all, g, *eit));
+    }
+
+    graph h(boost::edges_are_unsorted_multi_pass, arcs.begin(), arcs.end(), properties.begin(),
+            boost::num_vertices(g));
+    if constexpr (!std::is_same_v<VertexProperty, boost::no_property>)
+        for (std::size_t v = 0; v < p.size(); ++v)
+            h[p.to_new[v]] = g[v];
+    return h;
+}
+
+/** Rearrange values indexed by old vertex id (e.g. an external property map) to be indexed by new id. **/
+template<typename T>
+std::vector<T> permute(const std::vector<T> &values, const vertex_permutation &p) {
+    std::vector<T> result(values.size());
+    for (std::size_t v = 0; v < values.size(); ++v)
+        result[p.to_new[v]] = values[v];
+    return result;
+}
+
+/** The inverse of permute: translate values indexed by new vertex id, like BFS distances, back to the old ids. **/
+template<typename T>
+std::vector<T> restore(const std::vector<T> &values, const vertex_permutation &p) {
+    std::vector<T> result(values.size());
+    for (std::size_t v = 0; v < values.size(); ++v)
+        result[p.to_old[v]] = values[v];
+    return result;
+}
+
+/** As restore, for results whose values are themselves vertex ids, like predecessors: those are translated too. **/
+std::vector<std::size_t> restore_vertices(const std::vector<std::size_t> &vertices, const vertex_permutation &p) {
+    std::vector<std::size_t> result(vertices.size());
+    for (std::size_t v = 0; v < vertices.size(); ++v)
+        result[p.to_old[v]] = p.to_old[vertices[v]];
+    return result;
+}
@@ -0,0 +1,91 @@
+/**
+ * visitor_profile.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Profiling the visitor events of BFS and Dijkstra, on a grid and on an R-MAT graph.
+ *
+ * The grid has thousands of small levels, each with a handful of edges per vertex. The R-MAT graph has a few huge
+ * levels, and a few hubs that account for most of the edge scans. The profiles show the difference at a glance.
+ */
+
+// Profiling is opt-in: without this, profile_events is a null visitor and the profiles stay empty.
+#define GRAPH_PROFILE_VISITORS
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/graph/named_function_params.hpp>
+#include <boost/graph/visitors.hpp>
+
+#include "graph_common.h"
+#include "graph_builder.h"
+#include "generators.h"
+#include "visitor_profiling.h"
+
+int main() {
+    for (const auto &input: {grid_graph(300, 300), rmat_graph(15)}) {
+        const auto n = input.num_vertices;
+        const auto csr = build_csr(input.edges.begin(), input.edges.end(), n);
+        std::cout << input.name << ": " << n << " vertices, " << boost::num_edges(csr) << " arcs" << std::endl;
+
+        // Start from the vertex of highest degree, so that R-MAT's giant component is reached.
+        std::size_t source = 0;
+        for (std::size_t v = 0; v < n; ++v)
+            if (boost::out_degree(v, csr) > boost::out_degree(source, csr))
+                source = v;
+
+        // The profile goes alongside record_distances, in the same visitor list.
+        std::vector<int> distances(n, 0);
+        traversal_profile bfs_profile;
+        boost::breadth_first_search(csr, source,
+                boost::visitor(boost::make_bfs_visitor(std::make_pair(
+                        boost::record_distances(distances.data(), boost::on_tree_edge{}),
+                        profile_events(bfs_profile)))));
+        bfs_profile.finish();
+        std::cout << "BFS:" << std::endl;
+        bfs_profile.report(std::cout);
+
+        // Counting a single event costs even less.
+        traversal_profile trees;
+        boost::breadth_first_search(csr, source,
+                boost::visitor(boost::make_bfs_visitor(profile_event(trees, boost::on_tree_edge{}))));
+        std::cout << "tree edges on their own: " << trees.count<boost::on_tree_edge>() << std::endl;
+
+        // The overhead, against the same search without the profile.
+        const auto time = [&](auto &&visitor) {
+            const auto start = std::chrono::steady_clock::now();
+            boost::breadth_first_search(csr, source, boost::visitor(boost::make_bfs_visitor(visitor)));
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        };
+        traversal_profile again;
+        const auto plain = time(boost::record_distances(distances.data(), boost::on_tree_edge{}));
+        const auto profiled = time(std::make_pair(boost::record_distances(distances.data(), boost::on_tree_edge{}),
+                                                  profile_events(again)));
+        std::cout << "BFS " << plain << " ms, profiled " << profiled << " ms" << std::endl;
+
+        // Dijkstra has no levels, so its phases are windows of 1/16 of the vertices.
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<int> wdist(1, 100);
+        std::vector<int> weights(input.edges.size());
+        for (auto &w: weights)
+            w = wdist(gen);
+        const auto wcsr = make_weighted_csr(input.edges.begin(), input.edges.end(), weights.begin(), n);
+        traversal_profile dijkstra_profile{n / 16};
+        boost::dijkstra_shortest_paths(wcsr, source,
+                boost::distance_map(boost::make_iterator_property_map(distances.begin(),
+                                                                     boost::get(boost::vertex_index, wcsr)))
+                        .visitor(boost::make_dijkstra_visitor(profile_events(dijkstra_profile))));
+        dijkstra_profile.finish();
+        std::cout << "Dijkstra:" << std::endl;
+        dijkstra_profile.report(std::cout);
+        std::cout << std::endl;
+    }
+    return 0;
+}
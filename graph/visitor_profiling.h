@@ -0,0 +1,265 @@
+/**
+ * visitor_profiling.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Counting the visitor events of a traversal, to see where a slow search spends its time.
+ *
+ * bfs.cpp lists the events that BFS raises (examine_vertex, tree_edge, gray_target, ...), and record_distances
+ * shows how a visitor picks the ones it wants with a tag. profile_events(profile) is a visitor of the same kind,
+ * which listens to all of them, and can be put in the same list as record_distances:
+ *
+ *     traversal_profile profile;
+ *     boost::breadth_first_search(g, s, boost::visitor(boost::make_bfs_visitor(std::make_pair(
+ *             boost::record_distances(d, boost::on_tree_edge{}), profile_events(profile)))));
+ *     profile.finish();
+ *     profile.report(std::cout);
+ *
+ * It works with make_dijkstra_visitor in the same way. The profile counts every event, and splits the search into
+ * phases, recording for each one the size of the frontier at its start, the vertices and edges it examined, and the
+ * time it took. For BFS, the phases are the levels; Dijkstra has no levels, so give the profile a window, and each
+ * phase is that many examined vertices. A phase that is slow with few vertices and many edges is bound by edge scans
+ * (hubs); one that is slow with many vertices and few edges each is bound by the frontier.
+ *
+ * The clock is only read at the start of each phase, so the overhead is a few increments per event. Unless
+ * GRAPH_PROFILE_VISITORS is defined, profile_events and profile_event are a boost::null_visitor, which listens to no
+ * events at all, so the profiling compiles away entirely and the profile stays empty.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/graph/visitors.hpp>
+
+/** The events, phases and timings of one traversal. **/
+class traversal_profile {
+public:
+    using clock = std::chrono::steady_clock;
+
+#ifdef GRAPH_PROFILE_VISITORS
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    /** A BFS level, or a window of a Dijkstra search. **/
+    struct phase {
+        // The number of vertices discovered but not yet examined when the phase started.
+        std::size_t frontier = 0;
+        std::size_t vertices = 0;
+        std::uint64_t edges = 0;
+        double ms = 0;
+    };
+
+    /** With a window of 0, each phase is a BFS level; otherwise it is the next window examined vertices. **/
+    explicit traversal_profile(const std::size_t window = 0) : window_{window} {}
+
+    /** Note an event, given by its tag (e.g. boost::on_tree_edge). This is what the visitors call. **/
+    template<typename Tag>
+    void record() {
+        ++events_[Tag::num];
+        if constexpr (int{Tag::num} == boost::on_initialize_vertex::num) {
+            if (!started_)
+                start();
+        } else if constexpr (int{Tag::num} == boost::on_discover_vertex::num) {
+            if (!started_)
+                start();
+            if (!searching_) {
+                searching_ = true;
+                initialize_ms_ = elapsed_ms(start_, clock::now());
+            }
+            ++discovered_;
+        } else if constexpr (int{Tag::num} == boost::on_examine_vertex::num) {
+            if (examined_ == boundary_)
+                next_phase();
+            ++examined_;
+            ++phases_.back().vertices;
+        } else if constexpr (int{Tag::num} == boost::on_examine_edge::num) {
+            if (!phases_.empty())
+                ++phases_.back().edges;
+        }
+    }
+
+    /** Close the last phase. Call this once the algorithm returns. **/
+    void finish() {
+        if (!started_)
+            return;
+        const auto now = clock::now();
+        if (!phases_.empty())
+            phases_.back().ms = elapsed_ms(phase_start_, now);
+        total_ms_ = elapsed_ms(start_, now);
+    }
+
+    /** Forget everything, to profile another traversal. **/
+    void clear() {
+        *this = traversal_profile{window_};
+    }
+
+    /** The number of times the event with the given tag happened. **/
+    template<typename Tag>
+    std::uint64_t count() const { return events_[Tag::num]; }
+
+    const std::vector<phase> &phases() const { return phases_; }
+
+    /** The time spent initializing the vertices, before the first was discovered. **/
+    double initialize_ms() const { return initialize_ms_; }
+    double total_ms() const { return total_ms_; }
+
+    /**
+     * Print the event counts and the phases, with a summary of where the time went. If there are more phases than
+     * rows, neighbouring phases are merged, showing the largest frontier among them.
+     */
+    void report(std::ostream &out, const std::size_t rows = 16) const {
+        if (!enabled) {
+            out << "(profiling is compiled out: define GRAPH_PROFILE_VISITORS)" << std::endl;
+            return;
+        }
+
+        out << "events:";
+        for (std::size_t e = 0; e < events_.size(); ++e)
+            if (events_[e])
+                out << ' ' << event_names[e] << '=' << events_[e];
+        out << std::endl;
+
+        const auto per_row = std::max<std::size_t>(1, (phases_.size() + rows - 1) / std::max<std::size_t>(1, rows));
+        std::vector<std::pair<std::size_t, phase>> merged;
+        for (std::size_t i = 0; i < phases_.size(); ++i) {
+            const auto &p = phases_[i];
+            if (i % per_row == 0)
+                merged.emplace_back(i, phase{});
+            auto &m = merged.back().second;
+            m.frontier = std::max(m.frontier, p.frontier);
+            m.vertices += p.vertices;
+            m.edges += p.edges;
+            m.ms += p.ms;
+        }
+
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(3);
+        out << std::setw(12) << (window_ ? "window" : "level") << std::setw(12) << "frontier" << std::setw(12)
+            << "vertices" << std::setw(12) << "edges" << std::setw(12) << "edges/v" << std::setw(12) << "ms" << std::endl;
+        std::size_t slowest = 0;
+        for (std::size_t r = 0; r < merged.size(); ++r) {
+            const auto &[first, p] = merged[r];
+            const auto last = std::min(first + per_row, phases_.size()) - 1;
+            out << std::setw(12) << (first == last ? std::to_string(first) : std::to_string(first) + "-" + std::to_string(last))
+                << std::setw(12) << p.frontier << std::setw(12) << p.vertices << std::setw(12) << p.edges
+                << std::setw(12) << (p.vertices ? double(p.edges) / p.vertices : 0.0) << std::setw(12) << p.ms
+                << std::endl;
+            if (p.ms > merged[slowest].second.ms)
+                slowest = r;
+        }
+
+        out << "initialize " << initialize_ms_ << " ms, total " << total_ms_ << " ms";
+        if (!merged.empty() && total_ms_ > 0) {
+            // Whether the slowest row is slow because of its vertices or its edges.
+            const auto &p = merged[slowest].second;
+            const auto edges = count<boost::on_examine_edge>();
+            out << std::setprecision(1) << "; the slowest row took " << 100 * p.ms / total_ms_ << "% of the time for "
+                << (examined_ ? 100.0 * p.vertices / examined_ : 0.0) << "% of the vertices and "
+                << (edges ? 100.0 * p.edges / edges : 0.0) << "% of the edges";
+        }
+        out << std::endl;
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+private:
+    static constexpr const char *event_names[] = {
+            "none", "initialize_vertex", "start_vertex", "discover_vertex", "finish_vertex", "examine_vertex",
+            "examine_edge", "tree_edge", "non_tree_edge", "gray_target", "black_target", "forward_or_cross_edge",
+            "back_edge", "finish_edge", "edge_relaxed", "edge_not_relaxed", "edge_minimized", "edge_not_minimized"};
+
+    static double elapsed_ms(const clock::time_point from, const clock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    void start() {
+        started_ = true;
+        start_ = clock::now();
+    }
+
+    void next_phase() {
+        const auto now = clock::now();
+        if (!phases_.empty())
+            phases_.back().ms = elapsed_ms(phase_start_, now);
+        phase_start_ = now;
+        phases_.push_back({discovered_ - examined_, 0, 0, 0});
+        // A BFS level ends when everything discovered before it started has been examined.
+        boundary_ = window_ ? examined_ + window_ : discovered_;
+    }
+
+    std::size_t window_;
+    std::array<std::uint64_t, sizeof event_names / sizeof *event_names> events_{};
+    std::vector<phase> phases_;
+
+    bool started_ = false;
+    bool searching_ = false;
+    std::size_t discovered_ = 0;
+    std::size_t examined_ = 0;
+    std::size_t boundary_ = 0;
+
+    clock::time_point start_;
+    clock::time_point phase_start_;
+    double initialize_ms_ = 0;
+    double total_ms_ = 0;
+};
+
+/** An event visitor that notes every event of one kind in a profile. **/
+template<typename Tag>
+struct event_profiler : public boost::base_visitor<event_profiler<Tag>> {
+    using event_filter = Tag;
+
+    explicit event_profiler(traversal_profile &profile) : profile{&profile} {}
+
+    template<typename T, typename Graph>
+    void operator()(T, const Graph &) { profile->record<Tag>(); }
+
+    traversal_profile *profile;
+};
+
+namespace detail {
+    template<typename Tag, typename... Tags>
+    auto profile_events_for(traversal_profile &profile) {
+        if constexpr (sizeof...(Tags) == 0)
+            return event_profiler<Tag>{profile};
+        else
+            return std::make_pair(event_profiler<Tag>{profile}, profile_events_for<Tags...>(profile));
+    }
+}
+
+/**
+ * Profile one event only, like record_distances(d, tag). Note that the phases need the discover_vertex,
+ * examine_vertex and examine_edge events.
+ */
+template<typename Tag>
+auto profile_event([[maybe_unused]] traversal_profile &profile, Tag) {
+#ifdef GRAPH_PROFILE_VISITORS
+    return event_profiler<Tag>{profile};
+#else
+    return boost::null_visitor{};
+#endif
+}
+
+/** Profile all of the events of BFS and Dijkstra. **/
+inline auto profile_events([[maybe_unused]] traversal_profile &profile) {
+#ifdef GRAPH_PROFILE_VISITORS
+    return detail::profile_events_for<
+            boost::on_initialize_vertex, boost::on_discover_vertex, boost::on_examine_vertex, boost::on_examine_edge,
+            boost::on_tree_edge, boost::on_non_tree_edge, boost::on_gray_target, boost::on_black_target,
+            boost::on_edge_relaxed, boost::on_edge_not_relaxed, boost::on_finish_vertex>(profile);
+#else
+    return boost::null_visitor{};
+#endif
+}
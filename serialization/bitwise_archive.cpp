@@ -0,0 +1,138 @@
+/**
+ * bitwise_archive.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Taking the per-element overhead out of serializing big vectors with portable_oarchive.
+ *
+ * A std::vector of numbers is written as one block. So is a vector of a user type that opts in with
+ * BOOST_IS_BITWISE_SERIALIZABLE. A type that holds a string can't be copied as a block, but can still be spared the
+ * class information and object tracking that the library does for every element by default.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/serialization/level.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/tracking.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "portable_archive.h"
+
+// The same measurement, twice: one serialized field by field, and one copied as a block.
+struct sample {
+    std::int32_t legs;
+    float weight;
+    std::uint32_t id;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int) {
+        ar & legs & weight & id;
+    }
+};
+
+struct bitwise_sample {
+    std::int32_t legs;
+    float weight;
+    std::uint32_t id;
+
+    // Never called by portable archives, but still needed by the others.
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int) {
+        ar & legs & weight & id;
+    }
+};
+
+BOOST_IS_BITWISE_SERIALIZABLE(bitwise_sample)
+
+// The animal from example64_6, twice: with the library's bookkeeping, and without.
+struct animal {
+    int legs_;
+    std::string name_;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int) {
+        ar & legs_ & name_;
+    }
+};
+
+struct plain_animal {
+    int legs_;
+    std::string name_;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int) {
+        ar & legs_ & name_;
+    }
+};
+
+// No class information (so no versions), and no tracking.
+BOOST_CLASS_IMPLEMENTATION(plain_animal, boost::serialization::object_serializable)
+BOOST_CLASS_TRACKING(plain_animal, boost::serialization::track_never)
+
+/** Save and load the vector, and report the size and the times. **/
+template<typename T, typename Equal>
+void round_trip(const char *name, const std::vector<T> &original, Equal &&equal) {
+    std::stringstream ss;
+    auto start = std::chrono::steady_clock::now();
+    {
+        portable_oarchive oa{ss};
+        oa << original;
+    }
+    const std::chrono::duration<double, std::milli> saving = std::chrono::steady_clock::now() - start;
+
+    std::vector<T> copy;
+    start = std::chrono::steady_clock::now();
+    {
+        portable_iarchive ia{ss};
+        ia >> copy;
+    }
+    const std::chrono::duration<double, std::milli> loading = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": " << ss.str().size() / 1024 << " KB, save " << saving.count() << " ms, load "
+              << loading.count() << " ms, "
+              << (std::equal(copy.begin(), copy.end(), original.begin(), original.end(), equal) ? "same" : "DIFFERENT")
+              << std::endl;
+}
+
+int main() {
+    constexpr std::size_t n = 5000000;
+    const auto same = [](const auto &a, const auto &b) { return a.legs == b.legs && a.weight == b.weight && a.id == b.id; };
+
+    std::vector<sample> samples;
+    std::vector<bitwise_sample> bitwise_samples;
+    std::vector<double> weights;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto legs = static_cast<std::int32_t>(i % 9);
+        const auto weight = static_cast<float>(i % 1000) / 10;
+        const auto id = static_cast<std::uint32_t>(i * 2654435761u);
+        samples.push_back({legs, weight, id});
+        bitwise_samples.push_back({legs, weight, id});
+        weights.emplace_back(weight);
+    }
+
+    round_trip("samples, field by field", samples, same);
+    round_trip("samples, as a block", bitwise_samples, same);
+    round_trip("doubles, as a block", weights, std::equal_to<>{});
+
+    const char *names[] = {"cat", "dog", "spider", "snake", "bird"};
+    const int legs[] = {4, 4, 8, 0, 2};
+    std::vector<animal> animals;
+    std::vector<plain_animal> plain_animals;
+    for (std::size_t i = 0; i < n / 5; ++i) {
+        animals.push_back({legs[i % 5], names[i % 5]});
+        plain_animals.push_back({legs[i % 5], names[i % 5]});
+    }
+    const auto same_animal = [](const auto &a, const auto &b) { return a.legs_ == b.legs_ && a.name_ == b.name_; };
+    round_trip("animals, tracked", animals, same_animal);
+    round_trip("animals, untracked", plain_animals, same_animal);
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+/**
+ * chunked_archive.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Checkpointing a large state to a file, a pipe or a callback in chunks, instead of through a std::stringstream.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "chunked_archive.h"
+#include "portable_archive.h"
+
+struct animal {
+    int legs = 0;
+    std::string name;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int) {
+        ar & legs & name;
+    }
+
+    bool operator==(const animal &other) const { return legs == other.legs && name == other.name; }
+};
+
+struct state {
+    std::vector<animal> animals;
+    std::vector<double> weights;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int) {
+        ar & animals & weights;
+    }
+
+    bool operator==(const state &other) const { return animals == other.animals && weights == other.weights; }
+};
+
+/** The most memory the process has used so far, in MB. **/
+long peak_mb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;
+}
+
+template<typename F>
+double milliseconds(F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    state original;
+    const char *names[] = {"cat", "dog", "spider", "snake", "bird"};
+    for (std::size_t i = 0; i < 1000000; ++i)
+        original.animals.push_back({static_cast<int>(i % 9), names[i % 5]});
+    for (std::size_t i = 0; i < 16000000; ++i)
+        original.weights.push_back(static_cast<double>(i % 1000) / 10);
+    std::cout << "state built, peak " << peak_mb() << " MB" << std::endl;
+
+    // To a file, 1 MB at a time, with a thread that writes while the next chunk is filled.
+    const auto chunked = milliseconds([&] {
+        const int fd = ::open("checkpoint.bin", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        chunked_oarchive oa{fd_sink(fd), {1 << 20, 2}};
+        oa << original;
+        oa.close();
+        ::close(fd);
+    });
+    std::cout << "chunked: " << chunked << " ms, peak " << peak_mb() << " MB" << std::endl;
+
+    // The same file, through a std::stringstream, as in example64_3: the whole archive is held in memory.
+    const auto buffered = milliseconds([&] {
+        std::stringstream ss;
+        {
+            portable_oarchive oa{ss};
+            oa << original;
+        }
+        std::ofstream file{"checkpoint.bin", std::ios::binary};
+        file << ss.rdbuf();
+    });
+    std::cout << "stringstream: " << buffered << " ms, peak " << peak_mb() << " MB" << std::endl;
+
+    // And back, from the file written by the stringstream.
+    {
+        state copy;
+        const auto loading = milliseconds([&] {
+            const int fd = ::open("checkpoint.bin", O_RDONLY);
+            chunked_iarchive ia{fd_source(fd), {1 << 20, 2}};
+            ia >> copy;
+            ::close(fd);
+        });
+        std::cout << "restored: " << loading << " ms, " << (copy == original ? "same" : "DIFFERENT") << std::endl;
+    }
+
+    // Through a pipe, to a reader in another thread. The pipe is small, so the writer waits for the reader.
+    {
+        int fds[2];
+        if (::pipe(fds) != 0)
+            return 1;
+        std::thread writer{[&] {
+            chunked_oarchive oa{fd_sink(fds[1]), {64 << 10, 2}};
+            oa << original;
+            oa.close();
+            ::close(fds[1]);
+        }};
+
+        state copy;
+        {
+            chunked_iarchive ia{fd_source(fds[0]), {64 << 10, 2}};
+            ia >> copy;
+        }
+        writer.join();
+        ::close(fds[0]);
+        std::cout << "pipe: " << (copy == original ? "same" : "DIFFERENT") << std::endl;
+    }
+
+    // To a callback, with no thread: it sees every chunk as it is filled.
+    {
+        std::size_t chunks = 0, bytes = 0;
+        chunked_oarchive oa{[&](const char *, const std::size_t size) {
+            ++chunks;
+            bytes += size;
+        }, {4 << 20, 0}};
+        oa << original;
+        oa.close();
+        std::cout << "callback: " << chunks << " chunks, " << bytes / 1024 << " KB" << std::endl;
+    }
+
+    return 0;
+}
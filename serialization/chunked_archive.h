@@ -0,0 +1,413 @@
+/**
+ * chunked_archive.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Streaming a portable archive to and from a sink in fixed-size chunks, with bounded memory.
+ *
+ * example64_3 to example64_7 serialize into a std::stringstream, which holds the whole archive before any of it can
+ * be written anywhere: a multi-gigabyte checkpoint needs as much memory again to save. Here, the archive goes through
+ * a buffer of chunk_size bytes instead, and each full chunk is handed to a sink:
+ *
+ *     chunked_oarchive oa{fd_sink(fd), {1 << 20, 2}};
+ *     oa << state;
+ *     oa.close();
+ *
+ * A sink is anything that can be called with (const char *data, std::size_t size), e.g. fd_sink for a file or a pipe,
+ * ostream_sink, or a lambda. Every chunk is chunk_size bytes but the last. A source is the other way around: it is
+ * called with (char *data, std::size_t size), fills in up to size bytes, and returns how many, 0 meaning the end.
+ *
+ * With in_flight = 0, the sink is called by the thread that serializes, which waits while it writes. Otherwise a
+ * thread of its own writes the chunks, so serializing and writing overlap: once in_flight chunks are waiting, the
+ * archive waits for the sink. Either way, a slow sink holds back the archive rather than letting chunks pile up, and
+ * at most (in_flight + 1) * chunk_size bytes are buffered. Reading is the same, with a thread that reads ahead.
+ *
+ * The bytes are those of portable_oarchive (portable_archive.h): chunking is only how they travel, so a file written
+ * with a chunked_oarchive can be read with portable_iarchive or mapped_iarchive, and vice versa.
+ *
+ * Errors from the sink or source, e.g. the std::system_error thrown by fd_sink, come out of the archive's operators,
+ * or out of close(). The destructors close too, but can't report errors, so call close() after the last object.
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "portable_archive.h"
+
+/** Options for the chunked archives. **/
+struct chunked_archive_params {
+    // The size of a chunk, in bytes.
+    std::size_t chunk_size = 1 << 20;
+
+    // The number of chunks that can wait for the sink (or be read ahead from the source). 0 means none: the archive
+    // calls the sink or source itself.
+    unsigned in_flight = 1;
+};
+
+/** Where the chunks go: called with each one in turn. **/
+using chunk_sink = std::function<void(const char *, std::size_t)>;
+
+/** Where the chunks come from: fills in up to size bytes and returns how many, 0 at the end. **/
+using chunk_source = std::function<std::size_t(char *, std::size_t)>;
+
+/** Writes the chunks to a file descriptor, e.g. a file or a pipe. Doesn't close it. **/
+inline chunk_sink fd_sink(const int fd) {
+    return [fd](const char *data, std::size_t size) {
+        while (size) {
+            const auto written = ::write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "write");
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    };
+}
+
+/** Reads the chunks from a file descriptor. Doesn't close it. **/
+inline chunk_source fd_source(const int fd) {
+    return [fd](char *data, const std::size_t size) {
+        std::size_t total = 0;
+        while (total < size) {
+            const auto got = ::read(fd, data + total, size - total);
+            if (got < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "read");
+            }
+            if (got == 0)
+                break;
+            total += static_cast<std::size_t>(got);
+        }
+        return total;
+    };
+}
+
+inline chunk_sink ostream_sink(std::ostream &os) {
+    return [&os](const char *data, const std::size_t size) {
+        if (!os.write(data, static_cast<std::streamsize>(size)))
+            throw std::system_error(std::make_error_code(std::errc::io_error), "ostream_sink");
+    };
+}
+
+inline chunk_source istream_source(std::istream &is) {
+    return [&is](char *data, const std::size_t size) {
+        is.read(data, static_cast<std::streamsize>(size));
+        if (is.bad())
+            throw std::system_error(std::make_error_code(std::errc::io_error), "istream_source");
+        return static_cast<std::size_t>(is.gcount());
+    };
+}
+
+namespace chunked_archive_detail {
+    struct chunk {
+        std::vector<char> data;
+        std::size_t size = 0;
+    };
+
+    /**
+     * The chunks shared by the archive and the thread that writes or reads them: full ones waiting to be used, and
+     * free ones waiting to be filled. There are in_flight + 1 in all, so whoever runs out of free chunks waits. Only
+     * used when there is a thread to share them with.
+     **/
+    class chunk_pool {
+    public:
+        chunk_pool(const std::size_t chunk_size, const unsigned count) {
+            for (unsigned i = 0; i < count; ++i)
+                free_.push_back({std::vector<char>(chunk_size), 0});
+        }
+
+        /** A free chunk, or nothing if the pool has been stopped. **/
+        bool take_free(chunk &c) { return take(free_, c); }
+        bool take_full(chunk &c) { return take(full_, c); }
+
+        void give_free(chunk c) { give(free_, std::move(c)); }
+        void give_full(chunk c) { give(full_, std::move(c)); }
+
+        /** Wake everyone up, and make every take fail once there is nothing left to take. **/
+        void stop() {
+            std::lock_guard<std::mutex> lock{mutex_};
+            stopped_ = true;
+            cv_.notify_all();
+        }
+
+        /** Stop because of an error, which rethrow_error then throws on the other side, every time it is called. **/
+        void fail(std::exception_ptr error) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            error_ = std::move(error);
+            stopped_ = true;
+            cv_.notify_all();
+        }
+
+        void rethrow_error() {
+            std::lock_guard<std::mutex> lock{mutex_};
+            if (error_)
+                std::rethrow_exception(error_);
+        }
+
+    private:
+        bool take(std::deque<chunk> &from, chunk &c) {
+            std::unique_lock<std::mutex> lock{mutex_};
+            cv_.wait(lock, [&] { return !from.empty() || stopped_; });
+            if (from.empty())
+                return false;
+            c = std::move(from.front());
+            from.pop_front();
+            return true;
+        }
+
+        void give(std::deque<chunk> &to, chunk c) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            to.push_back(std::move(c));
+            cv_.notify_all();
+        }
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<chunk> free_;
+        std::deque<chunk> full_;
+        bool stopped_ = false;
+        std::exception_ptr error_;
+    };
+}
+
+/** A streambuf that hands what is written to it to a sink, a chunk at a time. **/
+class chunked_sink_buf : public std::streambuf {
+public:
+    explicit chunked_sink_buf(chunk_sink sink, const chunked_archive_params params = {})
+            : sink_{std::move(sink)}, pool_{params.chunk_size, params.in_flight ? params.in_flight + 1 : 0} {
+        if (params.in_flight)
+            writer_ = std::thread{[this] { write_chunks(); }};
+        else
+            current_.data.resize(params.chunk_size);
+        next_chunk();
+    }
+
+    chunked_sink_buf(const chunked_sink_buf &) = delete;
+    chunked_sink_buf &operator=(const chunked_sink_buf &) = delete;
+
+    ~chunked_sink_buf() override {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    /**
+     * Send the last chunk, and wait until the sink has had everything. Throws the sink's errors: once the sink has
+     * failed, some of the data is lost, so this (and every later call) throws the first error, even if it was
+     * already thrown by a write.
+     */
+    void close() {
+        if (!closed_) {
+            closed_ = true;
+            try {
+                if (!error_ && pptr() != pbase())
+                    send_chunk();
+            } catch (...) {
+                error_ = std::current_exception();
+            }
+            pool_.stop();
+            if (writer_.joinable())
+                writer_.join();
+            try {
+                if (!error_)
+                    pool_.rethrow_error();
+            } catch (...) {
+                error_ = std::current_exception();
+            }
+        }
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+protected:
+    // After an error, there is nowhere to put anything, so every write fails.
+    int_type overflow(const int_type c) override {
+        if (closed_ || error_)
+            return traits_type::eof();
+        try {
+            send_chunk();
+            next_chunk();
+        } catch (...) {
+            error_ = std::current_exception();
+            setp(nullptr, nullptr);
+            throw;
+        }
+        if (traits_type::eq_int_type(c, traits_type::eof()))
+            return traits_type::not_eof(c);
+        if (pptr() == epptr())
+            return traits_type::eof();
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        return c;
+    }
+
+private:
+    // Without a writer thread, there is only the one chunk. If the pool has stopped, the writer has failed.
+    void next_chunk() {
+        if (writer_.joinable() && !pool_.take_free(current_)) {
+            pool_.rethrow_error();
+            throw std::runtime_error("chunked_sink_buf: the writer has stopped");
+        }
+        setp(current_.data.data(), current_.data.data() + current_.data.size());
+    }
+
+    void send_chunk() {
+        current_.size = static_cast<std::size_t>(pptr() - pbase());
+        setp(nullptr, nullptr);
+        if (writer_.joinable()) {
+            pool_.rethrow_error();
+            pool_.give_full(std::move(current_));
+        } else
+            sink_(current_.data.data(), current_.size);
+    }
+
+    // The writer thread: gives each full chunk to the sink, and then back to the pool.
+    void write_chunks() {
+        try {
+            chunked_archive_detail::chunk c;
+            while (pool_.take_full(c)) {
+                sink_(c.data.data(), c.size);
+                pool_.give_free(std::move(c));
+            }
+        } catch (...) {
+            pool_.fail(std::current_exception());
+        }
+    }
+
+    chunk_sink sink_;
+    chunked_archive_detail::chunk_pool pool_;
+    chunked_archive_detail::chunk current_;
+    std::thread writer_;
+    bool closed_ = false;
+    std::exception_ptr error_;
+};
+
+/** A streambuf that reads from a source, a chunk at a time. **/
+class chunked_source_buf : public std::streambuf {
+public:
+    explicit chunked_source_buf(chunk_source source, const chunked_archive_params params = {})
+            : source_{std::move(source)}, pool_{params.chunk_size, params.in_flight ? params.in_flight + 1 : 0} {
+        if (params.in_flight)
+            reader_ = std::thread{[this] { read_chunks(); }};
+        else
+            current_.data.resize(params.chunk_size);
+    }
+
+    chunked_source_buf(const chunked_source_buf &) = delete;
+    chunked_source_buf &operator=(const chunked_source_buf &) = delete;
+
+    /** Stops reading ahead. If the source is in the middle of a read, waits for it. **/
+    ~chunked_source_buf() override {
+        pool_.stop();
+        if (reader_.joinable())
+            reader_.join();
+    }
+
+protected:
+    int_type underflow() override {
+        if (gptr() < egptr())
+            return traits_type::to_int_type(*gptr());
+        if (done_)
+            return traits_type::eof();
+
+        if (reader_.joinable()) {
+            if (!current_.data.empty())
+                pool_.give_free(std::move(current_));
+            if (!pool_.take_full(current_)) {
+                pool_.rethrow_error();
+                done_ = true;
+                return traits_type::eof();
+            }
+        } else
+            current_.size = source_(current_.data.data(), current_.data.size());
+
+        if (current_.size == 0) {
+            done_ = true;
+            setg(nullptr, nullptr, nullptr);
+            return traits_type::eof();
+        }
+        setg(current_.data.data(), current_.data.data(), current_.data.data() + current_.size);
+        return traits_type::to_int_type(*gptr());
+    }
+
+private:
+    // The reader thread: fills each free chunk from the source, and queues it. The last one is empty.
+    void read_chunks() {
+        try {
+            chunked_archive_detail::chunk c;
+            while (pool_.take_free(c)) {
+                std::size_t size = 0;
+                while (size < c.data.size()) {
+                    const auto got = source_(c.data.data() + size, c.data.size() - size);
+                    if (got == 0)
+                        break;
+                    size += got;
+                }
+                c.size = size;
+                pool_.give_full(std::move(c));
+                if (size == 0)
+                    return;
+            }
+        } catch (...) {
+            pool_.fail(std::current_exception());
+        }
+    }
+
+    chunk_source source_;
+    chunked_archive_detail::chunk_pool pool_;
+    chunked_archive_detail::chunk current_;
+    std::thread reader_;
+    bool done_ = false;
+};
+
+namespace chunked_archive_detail {
+    // The streambufs are bases of the archives, so that they are there before the header is written or read.
+    struct sink_holder {
+        chunked_sink_buf chunks;
+    };
+
+    struct source_holder {
+        chunked_source_buf chunks;
+    };
+}
+
+/** A portable_oarchive that writes to a sink in chunks. **/
+class chunked_oarchive : private chunked_archive_detail::sink_holder, public portable_oarchive {
+public:
+    explicit chunked_oarchive(chunk_sink sink, const chunked_archive_params params = {}, const unsigned int flags = 0)
+            : chunked_archive_detail::sink_holder{chunked_sink_buf{std::move(sink), params}},
+              portable_oarchive(chunks, flags) {}
+
+    /** Send what is left to the sink, and wait for it. Throws the sink's errors. **/
+    void close() { chunks.close(); }
+};
+
+/** A portable_iarchive that reads from a source in chunks. **/
+class chunked_iarchive : private chunked_archive_detail::source_holder, public portable_iarchive {
+public:
+    explicit chunked_iarchive(chunk_source source, const chunked_archive_params params = {},
+                              const unsigned int flags = 0)
+            : chunked_archive_detail::source_holder{chunked_source_buf{std::move(source), params}},
+              portable_iarchive(chunks, flags) {}
+};
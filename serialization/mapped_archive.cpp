@@ -0,0 +1,124 @@
+/**
+ * mapped_archive.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Loading a portable archive in place with mapped_iarchive, instead of through a std::ifstream as in example64_2.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "mapped_archive.h"
+#include "portable_archive.h"
+
+// An animal, with its weight as measured every month of the year.
+struct animal {
+    int legs = 0;
+    std::string name;
+    std::vector<double> weights;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int) {
+        ar & legs & name & weights;
+    }
+};
+
+// The same animal, loaded in place: its name and weights point into the file.
+struct animal_view {
+    int legs = 0;
+    std::string_view name;
+    array_view<double> weights;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int) {
+        ar & legs & name & weights;
+    }
+};
+
+template<typename F>
+double milliseconds(F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    constexpr std::size_t n = 200000;
+    constexpr std::size_t wanted = 123456;
+    const char *names[] = {"cat", "dog", "spider", "snake", "bird"};
+    const int legs[] = {4, 4, 8, 0, 2};
+
+    std::vector<animal> animals;
+    std::vector<lazy<animal>> records;
+    for (std::size_t i = 0; i < n; ++i) {
+        animal a{legs[i % 5], names[i % 5] + std::to_string(i), std::vector<double>(12)};
+        for (std::size_t month = 0; month < a.weights.size(); ++month)
+            a.weights[month] = static_cast<double>(i % 50) + month / 10.0;
+        records.emplace_back(a);
+        animals.emplace_back(std::move(a));
+    }
+
+    {
+        std::ofstream file{"animals.bin", std::ios::binary};
+        portable_oarchive oa{file};
+        oa << animals;
+    }
+    {
+        std::ofstream file{"records.bin", std::ios::binary};
+        portable_oarchive oa{file};
+        oa << records;
+    }
+
+    // Everything, decoded and copied out of the file.
+    const auto copied = milliseconds([&] {
+        std::ifstream file{"animals.bin", std::ios::binary};
+        portable_iarchive ia{file};
+        std::vector<animal> loaded;
+        ia >> loaded;
+        std::cout << "copied:  " << loaded[wanted].name << " weighs " << loaded[wanted].weights[11] << std::endl;
+    });
+
+    // Everything, decoded, but with the strings and arrays left in the file.
+    const auto viewed = milliseconds([&] {
+        mapped_iarchive ia{"animals.bin"};
+        std::vector<animal_view> loaded;
+        ia >> loaded;
+        std::cout << "viewed:  " << loaded[wanted].name << " weighs " << loaded[wanted].weights[11] << std::endl;
+    });
+
+    // Only the lengths of the records, and the one record that is used.
+    const auto lazily = milliseconds([&] {
+        mapped_iarchive ia{"records.bin"};
+        std::vector<lazy<animal_view>> loaded;
+        ia >> loaded;
+        const auto &a = *loaded[wanted];
+        std::cout << "lazily:  " << a.name << " weighs " << a.weights[11] << " ("
+                  << (loaded[wanted + 1].decoded() ? "decoded" : "not decoded") << " next to it)" << std::endl;
+    });
+
+    std::cout << "copied " << copied << " ms, viewed " << viewed << " ms, lazily " << lazily << " ms" << std::endl;
+
+    // A string written by portable_oarchive can also be read in place from memory.
+    std::stringstream ss;
+    {
+        portable_oarchive oa{ss};
+        oa << std::string{"spider"};
+    }
+    const auto bytes = ss.str();
+    mapped_iarchive ia{bytes.data(), bytes.size()};
+    std::string_view name;
+    ia >> name;
+    std::cout << name << " is " << (name.data() >= bytes.data() && name.data() < bytes.data() + bytes.size() ?
+                                    "in place" : "a copy") << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,291 @@
+/**
+ * mapped_archive.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Reading a portable archive in place, through a memory mapping.
+ *
+ * example64_2 loads through a std::ifstream: every byte of the file is read, decoded and copied into new objects
+ * before any of it is used. mapped_iarchive reads the same format as portable_iarchive (portable_archive.h), but
+ * from a read-only mapping of the file, and adds two things:
+ *
+ * 1. Views. A std::string_view is loaded as a view of the string's bytes in the mapping, and an array_view<T> as a
+ *    view of a block of Ts. Nothing is copied, and pages are only read from disk when the views are used. On the
+ *    saving side they are written exactly like a std::string and a std::vector<T>, so a type can be saved with owning
+ *    members and loaded with views, or the other way around.
+ *
+ * 2. Lazy records. A lazy<T> is saved as its own little archive, prefixed with its length. Loading it just takes a
+ *    view of those bytes: T is only decoded the first time get() is called. Loading a std::vector<lazy<T>> thus costs
+ *    one length per element, and a consumer can decode the one record it wants out of a large file.
+ *
+ * Views and lazy records point into the mapping, so the mapped_iarchive must outlive them. Blocks can only be viewed
+ * on machines with the byte order that they were written in (little-endian): elsewhere, loading one throws. Each
+ * lazy record is a separate archive, so pointers in a record can't be shared with the rest of the archive.
+ *
+ *     mapped_iarchive ia{"records.bin"};
+ *     std::vector<lazy<animal_view>> records;
+ *     ia >> records;
+ *     std::cout << records[12345]->name << std::endl;
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/serialization/array_wrapper.hpp>
+#include <boost/serialization/collection_size_type.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/tracking.hpp>
+
+#include "portable_archive.h"
+
+namespace mapped_archive_detail {
+    /** A streambuf that reads from memory, and lets the archive look at the bytes without copying them. **/
+    class region_buf : public std::streambuf {
+    public:
+        void reset(const char *data, const std::size_t size) {
+            const auto begin = const_cast<char *>(data);
+            setg(begin, begin, begin + size);
+        }
+
+        const char *next() const { return gptr(); }
+        std::size_t remaining() const { return static_cast<std::size_t>(egptr() - gptr()); }
+        void skip(const std::size_t count) { setg(eback(), gptr() + count, egptr()); }
+    };
+
+    /** What the archive reads from. A base of mapped_iarchive, so that it is there before the header is read. **/
+    struct mapped_source {
+        explicit mapped_source(const std::string &filename)
+                : file{filename.c_str(), boost::interprocess::read_only},
+                  region{file, boost::interprocess::read_only} {
+            buf.reset(static_cast<const char *>(region.get_address()), region.get_size());
+        }
+
+        mapped_source(const char *data, const std::size_t size) {
+            buf.reset(data, size);
+        }
+
+        boost::interprocess::file_mapping file;
+        boost::interprocess::mapped_region region;
+        region_buf buf;
+    };
+}
+
+/** Reads an archive written by portable_oarchive in place, from a file or from memory. **/
+class mapped_iarchive : private mapped_archive_detail::mapped_source,
+                        public portable_iarchive_impl<mapped_iarchive> {
+    friend class boost::archive::detail::interface_iarchive<mapped_iarchive>;
+    friend class boost::archive::load_access;
+    friend class boost::archive::detail::common_iarchive<mapped_iarchive>;
+
+public:
+    /** Map the given file. Throws boost::interprocess::interprocess_exception if it can't. **/
+    explicit mapped_iarchive(const std::string &filename, const unsigned int flags = 0)
+            : mapped_archive_detail::mapped_source{filename},
+              portable_iarchive_impl<mapped_iarchive>(buf, flags) {}
+
+    /** Read from memory that someone else owns, and that must outlive the archive and everything loaded from it. **/
+    mapped_iarchive(const char *data, const std::size_t size, const unsigned int flags = 0)
+            : mapped_archive_detail::mapped_source{data, size},
+              portable_iarchive_impl<mapped_iarchive>(buf, flags) {}
+
+    /** The next count bytes, in place. **/
+    std::string_view view(const std::size_t count) {
+        if (count > buf.remaining())
+            fail(boost::archive::archive_exception::input_stream_error);
+        const auto data = buf.next();
+        buf.skip(count);
+        position_ += count;
+        return {data, count};
+    }
+
+    /** The next block of count Ts, written by portable_oarchive::save_array, in place. **/
+    template<typename T>
+    const T *view_array(const std::size_t count) {
+        static_assert(portable_archive_detail::is_bitwise<T> && !std::is_same_v<T, bool>,
+                      "Only blocks of bitwise serializable types can be viewed.");
+        if constexpr (std::is_arithmetic_v<T> && !portable_archive_detail::is_native_block<T>)
+            fail(boost::archive::archive_exception::incompatible_native_format);
+
+        align(portable_archive_detail::alignment<T>);
+        if (count > buf.remaining() / sizeof(T))
+            fail(boost::archive::archive_exception::input_stream_error);
+        const auto data = view(count * sizeof(T)).data();
+        if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) != 0)
+            fail(boost::archive::archive_exception::incompatible_native_format);
+        return reinterpret_cast<const T *>(data);
+    }
+
+protected:
+    using portable_iarchive_impl<mapped_iarchive>::load;
+
+    void load(std::string_view &s) {
+        s = view(load_unsigned<std::size_t>());
+    }
+};
+
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(mapped_iarchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(mapped_iarchive)
+
+/**
+ * A read-only view of an array of Ts. Saved like a std::vector<T>, by any archive; loaded in place, by a
+ * mapped_iarchive. T must be bitwise serializable.
+ **/
+template<typename T>
+class array_view {
+public:
+    array_view() = default;
+    array_view(const T *data, const std::size_t size) : data_{data}, size_{size} {}
+
+    template<typename Allocator>
+    array_view(const std::vector<T, Allocator> &v) : data_{v.data()}, size_{v.size()} {}
+
+    const T *data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const T *begin() const { return data_; }
+    const T *end() const { return data_ + size_; }
+    const T &operator[](const std::size_t i) const { return data_[i]; }
+
+private:
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void save(Archive &ar, const unsigned int) const {
+        const boost::serialization::collection_size_type count(size_);
+        ar << count;
+        if (size_)
+            ar << boost::serialization::make_array(data_, size_);
+    }
+
+    template<typename Archive>
+    void load(Archive &ar, const unsigned int) {
+        static_assert(std::is_same_v<Archive, mapped_iarchive>, "Only a mapped_iarchive can load an array_view.");
+        boost::serialization::collection_size_type count;
+        ar >> count;
+        data_ = count ? ar.template view_array<T>(count) : nullptr;
+        size_ = count;
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+    const T *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+/**
+ * A T that is saved by portable_oarchive as a length-prefixed record, and that a mapped_iarchive only decodes when it
+ * is first used. get() caches the result, and so isn't safe to call from several threads at once.
+ **/
+template<typename T>
+class lazy {
+public:
+    lazy() = default;
+    lazy(T value) : value_{std::move(value)} {}
+
+    const T &get() const {
+        if (!value_) {
+            mapped_iarchive ia{bytes_.data(), bytes_.size(), boost::archive::no_header};
+            ia.set_library_version(library_);
+            T t;
+            ia >> t;
+            value_ = std::move(t);
+        }
+        return *value_;
+    }
+
+    const T &operator*() const { return get(); }
+    const T *operator->() const { return &get(); }
+
+    /** Whether the record has been decoded (or never needed to be). **/
+    bool decoded() const { return value_.has_value(); }
+
+private:
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    void save(Archive &ar, const unsigned int) const {
+        static_assert(std::is_same_v<Archive, portable_oarchive>, "Only a portable_oarchive can save a lazy record.");
+
+        // A record that was never decoded is saved as it was loaded.
+        std::string encoded;
+        std::string_view bytes = bytes_;
+        if (value_) {
+            std::stringbuf buf;
+            {
+                portable_oarchive oa{buf, boost::archive::no_header};
+                oa << *value_;
+            }
+            encoded = buf.str();
+            bytes = encoded;
+        }
+
+        // The record starts on the largest alignment, so the blocks in it are aligned in the whole archive too.
+        const boost::serialization::collection_size_type count(bytes.size());
+        ar << count;
+        ar.align(portable_archive_detail::max_alignment);
+        ar.save_binary(bytes.data(), bytes.size());
+    }
+
+    template<typename Archive>
+    void load(Archive &ar, const unsigned int) {
+        static_assert(std::is_same_v<Archive, mapped_iarchive>, "Only a mapped_iarchive can load a lazy record.");
+        boost::serialization::collection_size_type count;
+        ar >> count;
+        ar.align(portable_archive_detail::max_alignment);
+        bytes_ = ar.view(count);
+        library_ = ar.get_library_version();
+        value_.reset();
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+    mutable std::optional<T> value_;
+    std::string_view bytes_;
+    boost::serialization::library_version_type library_ = boost::archive::BOOST_ARCHIVE_VERSION();
+};
+
+// Neither needs class information or tracking: like a std::vector, they are written the same way every time.
+namespace boost {
+    namespace serialization {
+        template<typename T>
+        struct implementation_level<array_view<T>> {
+            typedef mpl::integral_c_tag tag;
+            typedef mpl::int_<object_serializable> type;
+            BOOST_STATIC_CONSTANT(int, value = type::value);
+        };
+
+        template<typename T>
+        struct tracking_level<array_view<T>> {
+            typedef mpl::integral_c_tag tag;
+            typedef mpl::int_<track_never> type;
+            BOOST_STATIC_CONSTANT(int, value = type::value);
+        };
+
+        template<typename T>
+        struct implementation_level<lazy<T>> {
+            typedef mpl::integral_c_tag tag;
+            typedef mpl::int_<object_serializable> type;
+            BOOST_STATIC_CONSTANT(int, value = type::value);
+        };
+
+        template<typename T>
+        struct tracking_level<lazy<T>> {
+            typedef mpl::integral_c_tag tag;
+            typedef mpl::int_<track_never> type;
+            BOOST_STATIC_CONSTANT(int, value = type::value);
+        };
+    }
+}
@@ -0,0 +1,149 @@
+/**
+ * portable_archive.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Using portable_oarchive and portable_iarchive in place of the text archives.
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "portable_archive.h"
+
+// The animal from example64_7, unchanged: its serialize function works with any archive.
+class animal {
+public:
+    animal() = default;
+    animal(int legs, std::string name) : legs_{legs}, name_{std::move(name)} {}
+
+    int legs() const { return legs_; }
+    const std::string &name() const { return name_; }
+
+    bool operator==(const animal &other) const { return legs_ == other.legs_ && name_ == other.name_; }
+
+private:
+    friend class boost::serialization::access;
+
+    template<typename Archive>
+    friend void serialize(Archive &ar, animal &a, const unsigned int version);
+
+    int legs_ = 0;
+    std::string name_;
+};
+
+template<typename Archive>
+void serialize(Archive &ar, animal &a, const unsigned int version) {
+    ar & a.legs_;
+    if (version > 0)
+        ar & a.name_;
+}
+
+BOOST_CLASS_VERSION(animal, 1)
+
+// A snapshot: some animals, and some measurements of them.
+struct snapshot {
+    std::vector<animal> animals;
+    std::vector<long> ids;
+    std::vector<double> weights;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int) {
+        ar & animals & ids & weights;
+    }
+
+    bool operator==(const snapshot &other) const {
+        return animals == other.animals && ids == other.ids && weights == other.weights;
+    }
+};
+
+/** Save and load the snapshot with the given archives, and report the size and the times. **/
+template<typename OArchive, typename IArchive>
+void round_trip(const char *name, const snapshot &original) {
+    std::stringstream ss;
+    auto start = std::chrono::steady_clock::now();
+    {
+        OArchive oa{ss};
+        oa << original;
+    }
+    const std::chrono::duration<double, std::milli> saving = std::chrono::steady_clock::now() - start;
+
+    snapshot copy;
+    start = std::chrono::steady_clock::now();
+    {
+        IArchive ia{ss};
+        ia >> copy;
+    }
+    const std::chrono::duration<double, std::milli> loading = std::chrono::steady_clock::now() - start;
+    std::cout << name << ": " << ss.str().size() / 1024 << " KB, save " << saving.count() << " ms, load "
+              << loading.count() << " ms, " << (copy == original ? "same" : "DIFFERENT") << std::endl;
+}
+
+int main() {
+    // As in example64_4, but portable: the bytes are the same on every platform.
+    {
+        std::stringstream ss;
+        {
+            portable_oarchive oa{ss};
+            const animal a{4, "cat"};
+            oa << a;
+        }
+        const auto bytes = ss.str();
+        std::cout << bytes.size() << " bytes:" << std::hex << std::setfill('0');
+        for (const auto c: bytes)
+            std::cout << ' ' << std::setw(2) << static_cast<int>(static_cast<unsigned char>(c));
+        std::cout << std::dec << std::setfill(' ') << std::endl;
+
+        portable_iarchive ia{ss};
+        animal a;
+        ia >> a;
+        std::cout << a.name() << " has " << a.legs() << " legs" << std::endl;
+    }
+
+    // A big snapshot, with the text archive and the portable one.
+    {
+        constexpr std::size_t n = 500000;
+        const char *names[] = {"cat", "dog", "spider", "snake", "bird"};
+        const int legs[] = {4, 4, 8, 0, 2};
+        std::mt19937 gen(0);
+        std::uniform_int_distribution<std::size_t> kind(0, 4);
+        std::uniform_int_distribution<long> id(0, 1000000);
+        std::uniform_real_distribution<double> weight(0, 50);
+
+        snapshot original;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto k = kind(gen);
+            original.animals.emplace_back(legs[k], names[k]);
+            original.ids.emplace_back(id(gen));
+            original.weights.emplace_back(weight(gen));
+        }
+
+        round_trip<boost::archive::text_oarchive, boost::archive::text_iarchive>("text", original);
+        round_trip<portable_oarchive, portable_iarchive>("portable", original);
+    }
+
+    // Loading something else is an error.
+    try {
+        std::stringstream ss;
+        {
+            boost::archive::text_oarchive oa{ss};
+            oa << 1;
+        }
+        portable_iarchive ia{ss};
+    } catch (const boost::archive::archive_exception &e) {
+        std::cout << "Not a portable archive: " << e.what() << std::endl;
+    }
+
+    return 0;
+}
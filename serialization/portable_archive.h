@@ -0,0 +1,549 @@
+/**
+ * portable_archive.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * A compact, portable binary archive: a drop-in replacement for text_oarchive and text_iarchive.
+ *
+ * The text archives write every int through the stream's locale machinery, separated by spaces, and parse it
+ * back on load. boost::archive::binary_oarchive is fast, but writes the native sizes and byte order of the machine,
+ * so its files can't be moved between platforms. portable_oarchive is modelled on the portable_binary_oarchive
+ * example that comes with Boost.Serialization, and writes a fixed layout instead:
+ *
+ * 1. Integers (including sizes, versions and class ids) are LEB128 varints: unsigned ones 7 bits per byte, low
+ *    bits first, with the top bit set on every byte but the last; signed ones the same, sign-extended from the last
+ *    byte (SLEB128). Small numbers, which are most of them, take one byte whatever their type.
+ *
+ * 2. bool and the char types are one byte. float and double are their IEEE 754 bits, little-endian.
+ *
+ * 3. Strings are their length as a varint, followed by their bytes. A std::string_view can be saved too, and loaded
+ *    as a std::string.
+ *
+ * 4. Arrays of numbers (std::vector, std::array, C arrays and make_array) are written as one block of fixed-width,
+ *    little-endian values rather than one varint at a time. The width of each type is the same on every platform:
+ *
+ *        bool, char, signed char, unsigned char      1 byte
+ *        short, unsigned short, char16_t             2 bytes
+ *        int, unsigned, char32_t, wchar_t, float     4 bytes
+ *        long, unsigned long, long long,
+ *        unsigned long long, double                  8 bytes
+ *
+ *    so std::int8_t to std::int64_t (and the unsigned ones) are their own size, and std::size_t is 8 bytes on every
+ *    64-bit platform. Where the native type is the same size (and the machine is little-endian) the block is a single
+ *    memcpy; where it is narrower, like long on Windows or wchar_t on Windows, each element is widened on saving, and
+ *    loading fails if a value doesn't fit. long double has no portable layout, and can't be saved at all. So are
+ *    user types that opt in with BOOST_IS_BITWISE_SERIALIZABLE, alone or in arrays: they must be trivially copyable,
+ *    and are copied byte for byte, so they must also have the same layout wherever the archive is read. Such types
+ *    never get class information or object tracking, and their serialize functions are never called.
+ *    Each block is preceded by zero bytes up to a multiple of its alignment (at most 8), counting from the start of
+ *    the archive, so that mapped_iarchive (mapped_archive.h) can hand it out in place.
+ *
+ * Types that can't be copied as a block can still skip the per-object bookkeeping of the library, with
+ * BOOST_CLASS_IMPLEMENTATION(T, boost::serialization::object_serializable) (no class information, hence no version)
+ * and BOOST_CLASS_TRACKING(T, boost::serialization::track_never) (no tracking of addresses). Each element of a
+ * std::vector<T> is then a direct call to serialize.
+ *
+ * The archives plug into the same serialize(Archive &, T &, const unsigned int version) functions as any other
+ * archive, so the examples only need to change the archive type:
+ *
+ *     portable_oarchive oa{file};
+ *     oa << a;
+ *
+ * Malformed input (a bad signature, a varint that doesn't fit its type, or a stream that ends early) throws a
+ * boost::archive::archive_exception, as the other archives do.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <boost/archive/archive_exception.hpp>
+#include <boost/archive/basic_archive.hpp>
+#include <boost/archive/detail/common_iarchive.hpp>
+#include <boost/archive/detail/common_oarchive.hpp>
+#include <boost/archive/detail/register_archive.hpp>
+#include <boost/serialization/collection_size_type.hpp>
+#include <boost/serialization/item_version_type.hpp>
+#include <boost/serialization/throw_exception.hpp>
+
+// The archive's serializer map is a template defined in the library's sources: including the definitions here
+// instantiates it for the archives below, which pointer serialization needs.
+#include <boost/archive/impl/archive_serializer_map.ipp>
+#include <boost/mpl/bool.hpp>
+#include <boost/predef/other/endian.h>
+#include <boost/serialization/array_optimization.hpp>
+#include <boost/serialization/array_wrapper.hpp>
+#include <boost/serialization/is_bitwise_serializable.hpp>
+#include <boost/serialization/level.hpp>
+
+namespace portable_archive_detail {
+    // Every archive starts with these bytes, then the format version and the Boost library version as varints.
+    // Version 1 wrote arrays one element at a time, version 2 didn't align them, and version 3 wrote them at their
+    // native sizes: none of them can be read any more.
+    constexpr char signature[] = {'B', 'P', 'A', 'R'};
+    constexpr unsigned format_version = 4;
+
+    constexpr bool little_endian = BOOST_ENDIAN_LITTLE_BYTE;
+
+    // Whether a T is copied as a block. The library's own bookkeeping types say they are bitwise serializable too,
+    // but they are primitives, which are written as varints.
+    template<typename T>
+    constexpr bool is_bitwise = boost::serialization::is_bitwise_serializable<T>::value
+                                && (std::is_arithmetic_v<T> || boost::serialization::implementation_level<T>::value
+                                                               != boost::serialization::primitive_type)
+                                && !std::is_same_v<T, long double>;
+
+    template<typename T>
+    constexpr bool is_bitwise_class = std::is_class_v<T> && is_bitwise<T>;
+
+    // The integer types whose size differs between platforms (4 or 8 bytes), which blocks always store in 8.
+    template<typename T>
+    constexpr bool is_long = std::is_same_v<T, long> || std::is_same_v<T, unsigned long>
+                             || std::is_same_v<T, long long> || std::is_same_v<T, unsigned long long>;
+
+    static_assert(sizeof(short) == 2 && sizeof(int) == 4, "Blocks assume 16-bit shorts and 32-bit ints.");
+
+    // The size of a T in a block: see the table above. Classes are copied as they are.
+    template<typename T>
+    constexpr std::size_t block_size = is_long<T> ? 8 : std::is_same_v<T, wchar_t> ? 4 : sizeof(T);
+
+    // Whether a block of Ts is the same bytes in memory and in the archive.
+    template<typename T>
+    constexpr bool is_native_block = block_size<T> == sizeof(T) && (sizeof(T) == 1 || little_endian);
+
+    // The unsigned integer of each block size.
+    template<std::size_t N>
+    using fixed_unsigned = std::conditional_t<N == 2, std::uint16_t,
+            std::conditional_t<N == 4, std::uint32_t, std::uint64_t>>;
+
+    // Blocks are aligned to the size of a number, or the alignment of a class, up to this.
+    constexpr std::size_t max_alignment = 8;
+
+    template<typename T>
+    constexpr std::size_t alignment = std::min(std::is_arithmetic_v<T> ? block_size<T> : alignof(T), max_alignment);
+
+    template<typename T>
+    constexpr bool is_byte = std::is_same_v<T, char> || std::is_same_v<T, signed char>
+                             || std::is_same_v<T, unsigned char>;
+
+    template<typename T>
+    constexpr bool always_false = false;
+}
+
+/** Writes a portable binary archive to a stream. **/
+class portable_oarchive : public boost::archive::detail::common_oarchive<portable_oarchive> {
+    friend class boost::archive::detail::interface_oarchive<portable_oarchive>;
+    friend class boost::archive::save_access;
+    friend class boost::archive::detail::common_oarchive<portable_oarchive>;
+
+public:
+    explicit portable_oarchive(std::ostream &os, const unsigned int flags = 0)
+            : portable_oarchive(*os.rdbuf(), flags) {}
+
+    explicit portable_oarchive(std::streambuf &buf, const unsigned int flags = 0)
+            : boost::archive::detail::common_oarchive<portable_oarchive>(flags), buf_{buf} {
+        if (!(flags & boost::archive::no_header)) {
+            save_binary(portable_archive_detail::signature, sizeof portable_archive_detail::signature);
+            save_unsigned(portable_archive_detail::format_version);
+            save_unsigned(static_cast<unsigned>(boost::archive::BOOST_ARCHIVE_VERSION()));
+        }
+    }
+
+    /** Raw bytes, e.g. from boost::serialization::make_binary_object. **/
+    void save_binary(const void *address, const std::size_t count) {
+        if (static_cast<std::size_t>(buf_.sputn(static_cast<const char *>(address), count)) != count)
+            boost::serialization::throw_exception(
+                    boost::archive::archive_exception(boost::archive::archive_exception::output_stream_error));
+        position_ += count;
+    }
+
+    /** The number of bytes written so far, header included. **/
+    std::size_t position() const { return position_; }
+
+    /** Write zero bytes until the position is a multiple of alignment. **/
+    void align(const std::size_t alignment) {
+        while (position_ % alignment)
+            put(0);
+    }
+
+    // Tells the containers to hand over arrays of bitwise types whole, to save_array.
+    struct use_array_optimization {
+        template<typename T>
+        struct apply : boost::mpl::bool_<portable_archive_detail::is_bitwise<T>> {};
+    };
+
+    template<typename T>
+    void save_array(const boost::serialization::array_wrapper<T> &a, const unsigned int) {
+        align(portable_archive_detail::alignment<T>);
+        save_block(a.address(), a.count());
+    }
+
+protected:
+    // The serialization library's own bookkeeping: all integers, so all varints. The optional class id is only
+    // needed by archives that tag their output, like XML.
+    template<typename T>
+    void save_override(const T &t) {
+        if constexpr (portable_archive_detail::is_bitwise_class<T>)
+            save_block(&t, 1);
+        else
+            boost::archive::detail::common_oarchive<portable_oarchive>::save_override(t);
+    }
+
+    void save_override(const boost::archive::class_id_optional_type &) {}
+
+    void save(const boost::archive::version_type &t) { save_unsigned(std::uint32_t{t}); }
+    void save(const boost::archive::class_id_type &t) { save_signed(std::int16_t{t}); }
+    void save(const boost::archive::class_id_reference_type &t) { save_signed(std::int16_t{t}); }
+    void save(const boost::archive::object_id_type &t) { save_unsigned(std::uint32_t{t}); }
+    void save(const boost::archive::object_reference_type &t) { save_unsigned(std::uint32_t{t}); }
+    void save(const boost::archive::tracking_type &t) { save(bool{t}); }
+    void save(const boost::serialization::library_version_type &t) { save_unsigned(std::uint16_t{t}); }
+    void save(const boost::serialization::collection_size_type &t) { save_unsigned(std::size_t{t}); }
+    void save(const boost::serialization::item_version_type &t) { save_unsigned(unsigned{t}); }
+
+    void save(const boost::archive::class_name_type &t) {
+        const char *name = t;
+        save_string(name, std::strlen(name));
+    }
+
+    void save(const std::string &s) { save_string(s.data(), s.size()); }
+    void save(const std::string_view &s) { save_string(s.data(), s.size()); }
+
+    void save(const std::wstring &s) {
+        save_unsigned(s.size());
+        for (const auto c: s)
+            save_unsigned(static_cast<std::uint32_t>(c));
+    }
+
+    template<typename T>
+    void save(const T &t) {
+        if constexpr (std::is_same_v<T, bool>)
+            put(t ? 1 : 0);
+        else if constexpr (portable_archive_detail::is_byte<T>)
+            put(static_cast<unsigned char>(t));
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            save_signed(t);
+        else if constexpr (std::is_integral_v<T>)
+            save_unsigned(t);
+        else if constexpr (std::is_same_v<T, float>)
+            save_fixed(bits<std::uint32_t>(t));
+        else if constexpr (std::is_same_v<T, double>)
+            save_fixed(bits<std::uint64_t>(t));
+        else
+            static_assert(portable_archive_detail::always_false<T>, "portable_oarchive can't save this type.");
+    }
+
+private:
+    void put(const unsigned char byte) {
+        if (buf_.sputc(static_cast<char>(byte)) == std::char_traits<char>::eof())
+            boost::serialization::throw_exception(
+                    boost::archive::archive_exception(boost::archive::archive_exception::output_stream_error));
+        ++position_;
+    }
+
+    void save_unsigned(std::uintmax_t x) {
+        while (x >= 0x80) {
+            put(static_cast<unsigned char>(x | 0x80));
+            x >>= 7;
+        }
+        put(static_cast<unsigned char>(x));
+    }
+
+    void save_signed(std::intmax_t x) {
+        // Stop once the rest is all sign: all zeros with the sign bit of the last byte clear, or all ones with it set.
+        while (true) {
+            const auto byte = static_cast<unsigned char>(x & 0x7f);
+            x >>= 7;
+            if ((x == 0 && !(byte & 0x40)) || (x == -1 && (byte & 0x40))) {
+                put(byte);
+                return;
+            }
+            put(byte | 0x80);
+        }
+    }
+
+    template<typename U>
+    void save_fixed(const U x) {
+        for (std::size_t i = 0; i < sizeof x; ++i)
+            put(static_cast<unsigned char>(x >> (8 * i)));
+    }
+
+    void save_string(const char *data, const std::size_t size) {
+        save_unsigned(size);
+        save_binary(data, size);
+    }
+
+    template<typename T>
+    void save_block(const T *data, const std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "Bitwise serializable types must be trivially copyable.");
+        using portable_archive_detail::block_size;
+        if constexpr (std::is_integral_v<T> && !portable_archive_detail::is_native_block<T>) {
+            // Widened (sign-extended if need be) to the block size, and written little-endian.
+            using U = portable_archive_detail::fixed_unsigned<block_size<T>>;
+            using W = std::conditional_t<std::is_signed_v<T>, std::make_signed_t<U>, U>;
+            static_assert(sizeof(T) <= sizeof(U), "Integers can only be widened in a block.");
+            for (std::size_t i = 0; i < count; ++i)
+                save_fixed(static_cast<U>(static_cast<W>(data[i])));
+        } else if constexpr (std::is_floating_point_v<T> && !portable_archive_detail::little_endian) {
+            for (std::size_t i = 0; i < count; ++i)
+                save(data[i]);
+        } else
+            save_binary(data, count * sizeof(T));
+    }
+
+    template<typename U, typename F>
+    static U bits(const F f) {
+        static_assert(sizeof(U) == sizeof(F) && std::numeric_limits<F>::is_iec559, "Floats must be IEEE 754.");
+        U u;
+        std::memcpy(&u, &f, sizeof u);
+        return u;
+    }
+
+    std::streambuf &buf_;
+    std::size_t position_ = 0;
+};
+
+/**
+ * Reads an archive written by portable_oarchive from a streambuf. As with Boost's binary_iarchive_impl, Archive is
+ * the most derived archive, so that archives that read from elsewhere (like mapped_iarchive) can add to it.
+ **/
+template<typename Archive>
+class portable_iarchive_impl : public boost::archive::detail::common_iarchive<Archive> {
+    friend class boost::archive::detail::interface_iarchive<Archive>;
+    friend class boost::archive::load_access;
+    friend class boost::archive::detail::common_iarchive<Archive>;
+
+public:
+    void load_binary(void *address, const std::size_t count) {
+        if (static_cast<std::size_t>(buf_.sgetn(static_cast<char *>(address), count)) != count)
+            fail(boost::archive::archive_exception::input_stream_error);
+        position_ += count;
+    }
+
+    /** The number of bytes read so far, header included. **/
+    std::size_t position() const { return position_; }
+
+    /** Skip the zero bytes that portable_oarchive::align wrote. **/
+    void align(const std::size_t alignment) {
+        while (position_ % alignment)
+            load_byte();
+    }
+
+    struct use_array_optimization {
+        template<typename T>
+        struct apply : boost::mpl::bool_<portable_archive_detail::is_bitwise<T>> {};
+    };
+
+    template<typename T>
+    void load_array(boost::serialization::array_wrapper<T> &a, const unsigned int) {
+        align(portable_archive_detail::alignment<T>);
+        load_block(a.address(), a.count());
+    }
+
+protected:
+    portable_iarchive_impl(std::streambuf &buf, const unsigned int flags)
+            : boost::archive::detail::common_iarchive<Archive>(flags), buf_{buf} {
+        if (!(flags & boost::archive::no_header)) {
+            char signature[sizeof portable_archive_detail::signature];
+            load_binary(signature, sizeof signature);
+            if (std::memcmp(signature, portable_archive_detail::signature, sizeof signature) != 0)
+                fail(boost::archive::archive_exception::invalid_signature);
+            if (load_unsigned<unsigned>() != portable_archive_detail::format_version)
+                fail(boost::archive::archive_exception::unsupported_version);
+            const auto library = load_unsigned<std::uint16_t>();
+            if (boost::serialization::library_version_type(library) > boost::archive::BOOST_ARCHIVE_VERSION())
+                fail(boost::archive::archive_exception::unsupported_version);
+            this->set_library_version(boost::serialization::library_version_type(library));
+        }
+    }
+
+    template<typename T>
+    void load_override(T &t) {
+        if constexpr (portable_archive_detail::is_bitwise_class<T>)
+            load_block(&t, 1);
+        else
+            boost::archive::detail::common_iarchive<Archive>::load_override(t);
+    }
+
+    void load_override(boost::archive::class_id_optional_type &) {}
+
+    void load(boost::archive::version_type &t) { t = boost::archive::version_type(load_unsigned<std::uint32_t>()); }
+    void load(boost::archive::class_id_type &t) { t = boost::archive::class_id_type(load_signed<std::int16_t>()); }
+    void load(boost::archive::object_id_type &t) {
+        t = boost::archive::object_id_type(load_unsigned<std::uint32_t>());
+    }
+    void load(boost::archive::tracking_type &t) { t = boost::archive::tracking_type(load_byte() != 0); }
+    void load(boost::serialization::library_version_type &t) {
+        t = boost::serialization::library_version_type(load_unsigned<std::uint16_t>());
+    }
+    void load(boost::serialization::collection_size_type &t) {
+        t = boost::serialization::collection_size_type(load_unsigned<std::size_t>());
+    }
+    void load(boost::serialization::item_version_type &t) {
+        t = boost::serialization::item_version_type(load_unsigned<unsigned>());
+    }
+
+    void load(boost::archive::class_name_type &t) {
+        const auto size = load_unsigned<std::size_t>();
+        if (size >= BOOST_SERIALIZATION_MAX_KEY_SIZE)
+            fail(boost::archive::archive_exception::invalid_class_name);
+        char *name = t;
+        load_binary(name, size);
+        name[size] = '\0';
+    }
+
+    void load(std::string &s) {
+        s.resize(load_unsigned<std::size_t>());
+        load_binary(&s[0], s.size());
+    }
+
+    void load(std::wstring &s) {
+        s.resize(load_unsigned<std::size_t>());
+        for (auto &c: s)
+            c = static_cast<wchar_t>(load_unsigned<std::uint32_t>());
+    }
+
+    template<typename T>
+    void load(T &t) {
+        if constexpr (std::is_same_v<T, bool>)
+            t = load_byte() != 0;
+        else if constexpr (portable_archive_detail::is_byte<T>)
+            t = static_cast<T>(load_byte());
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            t = load_signed<T>();
+        else if constexpr (std::is_integral_v<T>)
+            t = load_unsigned<T>();
+        else if constexpr (std::is_same_v<T, float>)
+            t = from_bits<float>(load_fixed<std::uint32_t>());
+        else if constexpr (std::is_same_v<T, double>)
+            t = from_bits<double>(load_fixed<std::uint64_t>());
+        else
+            static_assert(portable_archive_detail::always_false<T>, "This archive can't load this type.");
+    }
+
+    [[noreturn]] static void fail(const boost::archive::archive_exception::exception_code code) {
+        boost::serialization::throw_exception(boost::archive::archive_exception(code));
+    }
+
+    unsigned char load_byte() {
+        const auto c = buf_.sbumpc();
+        if (c == std::char_traits<char>::eof())
+            fail(boost::archive::archive_exception::input_stream_error);
+        ++position_;
+        return static_cast<unsigned char>(c);
+    }
+
+    /** An unsigned varint, which must fit in a U. **/
+    template<typename U>
+    U load_unsigned() {
+        std::uintmax_t x = 0;
+        for (unsigned shift = 0; ; shift += 7) {
+            const auto byte = load_byte();
+            if (shift >= std::numeric_limits<std::uintmax_t>::digits
+                || (static_cast<std::uintmax_t>(byte & 0x7f) << shift >> shift) != (byte & 0x7fu))
+                fail(boost::archive::archive_exception::input_stream_error);
+            x |= static_cast<std::uintmax_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                break;
+        }
+        if (x > std::numeric_limits<U>::max())
+            fail(boost::archive::archive_exception::input_stream_error);
+        return static_cast<U>(x);
+    }
+
+    /** A signed varint, which must fit in an S. **/
+    template<typename S>
+    S load_signed() {
+        std::uintmax_t x = 0;
+        unsigned shift = 0;
+        unsigned char byte;
+        do {
+            byte = load_byte();
+            if (shift >= std::numeric_limits<std::uintmax_t>::digits)
+                fail(boost::archive::archive_exception::input_stream_error);
+            x |= static_cast<std::uintmax_t>(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        if (shift < std::numeric_limits<std::uintmax_t>::digits && (byte & 0x40))
+            x |= ~std::uintmax_t{0} << shift;
+
+        const auto value = static_cast<std::intmax_t>(x);
+        if (value < std::numeric_limits<S>::min() || value > std::numeric_limits<S>::max())
+            fail(boost::archive::archive_exception::input_stream_error);
+        return static_cast<S>(value);
+    }
+
+    template<typename U>
+    U load_fixed() {
+        U x = 0;
+        for (std::size_t i = 0; i < sizeof x; ++i)
+            x |= static_cast<U>(load_byte()) << (8 * i);
+        return x;
+    }
+
+    template<typename T>
+    void load_block(T *data, const std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "Bitwise serializable types must be trivially copyable.");
+        if constexpr (std::is_same_v<T, bool>) {
+            // Not every byte is a valid bool.
+            for (std::size_t i = 0; i < count; ++i)
+                data[i] = load_byte() != 0;
+        } else if constexpr (std::is_integral_v<T> && !portable_archive_detail::is_native_block<T>) {
+            // Narrowed from the block size, if the value fits.
+            using U = portable_archive_detail::fixed_unsigned<portable_archive_detail::block_size<T>>;
+            using W = std::conditional_t<std::is_signed_v<T>, std::make_signed_t<U>, U>;
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto value = static_cast<W>(load_fixed<U>());
+                if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max())
+                    fail(boost::archive::archive_exception::input_stream_error);
+                data[i] = static_cast<T>(value);
+            }
+        } else if constexpr (std::is_floating_point_v<T> && !portable_archive_detail::little_endian) {
+            for (std::size_t i = 0; i < count; ++i)
+                load(data[i]);
+        } else
+            load_binary(data, count * sizeof(T));
+    }
+
+    template<typename F, typename U>
+    static F from_bits(const U u) {
+        F f;
+        std::memcpy(&f, &u, sizeof f);
+        return f;
+    }
+
+    std::streambuf &buf_;
+    std::size_t position_ = 0;
+};
+
+/** Reads an archive written by portable_oarchive from a stream. **/
+class portable_iarchive : public portable_iarchive_impl<portable_iarchive> {
+    friend class boost::archive::detail::interface_iarchive<portable_iarchive>;
+    friend class boost::archive::load_access;
+    friend class boost::archive::detail::common_iarchive<portable_iarchive>;
+
+public:
+    explicit portable_iarchive(std::istream &is, const unsigned int flags = 0)
+            : portable_iarchive(*is.rdbuf(), flags) {}
+
+    explicit portable_iarchive(std::streambuf &buf, const unsigned int flags = 0)
+            : portable_iarchive_impl<portable_iarchive>(buf, flags) {}
+};
+
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(portable_oarchive)
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(portable_iarchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(portable_oarchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(portable_iarchive)
+
+// So that portable_oarchive can save a std::string_view directly, like a std::string.
+BOOST_CLASS_IMPLEMENTATION(std::string_view, boost::serialization::primitive_type)
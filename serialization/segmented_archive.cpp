@@ -0,0 +1,119 @@
+/**
+ * segmented_archive.cpp
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Checkpointing sharded state on every core, with a segmented archive, instead of through one archive on one thread.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "mapped_archive.h"
+#include "portable_archive.h"
+#include "segmented_archive.h"
+
+struct animal {
+    int legs = 0;
+    std::string name;
+
+    template<typename Archive>
+    void serialize(Archive &ar, const unsigned int) {
+        ar & legs & name;
+    }
+
+    bool operator==(const animal &other) const { return legs == other.legs && name == other.name; }
+};
+
+template<typename F>
+double milliseconds(F &&f) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    std::vector<animal> animals;
+    const char *names[] = {"cat", "dog", "spider", "snake", "bird"};
+    for (std::size_t i = 0; i < 2000000; ++i)
+        animals.push_back({static_cast<int>(i % 9), names[i % 5] + std::to_string(i)});
+    std::vector<double> weights(4000000);
+    for (std::size_t i = 0; i < weights.size(); ++i)
+        weights[i] = static_cast<double>(i % 1000) / 10;
+
+    std::cout << std::thread::hardware_concurrency() << " cores" << std::endl;
+
+    // One archive, written and read by one thread.
+    {
+        const auto saving = milliseconds([&] {
+            std::ofstream file{"animals.bin", std::ios::binary};
+            portable_oarchive oa{file};
+            oa << animals;
+        });
+        std::vector<animal> copy;
+        const auto loading = milliseconds([&] {
+            mapped_iarchive ia{"animals.bin"};
+            ia >> copy;
+        });
+        std::cout << "one archive: save " << saving << " ms, load " << loading << " ms, "
+                  << (copy == animals ? "same" : "DIFFERENT") << std::endl;
+    }
+
+    // The same vector, in shards, with one thread per core.
+    {
+        const auto saving = milliseconds([&] {
+            std::ofstream file{"animals.bin", std::ios::binary};
+            save_sharded(file, animals);
+        });
+        std::vector<animal> copy;
+        std::size_t segments = 0;
+        const auto loading = milliseconds([&] {
+            segmented_reader in{"animals.bin"};
+            load_sharded(in, copy);
+            segments = in.size();
+        });
+        std::cout << segments << " shards: save " << saving << " ms, load " << loading << " ms, "
+                  << (copy == animals ? "same" : "DIFFERENT") << std::endl;
+    }
+
+    // Separate top-level objects, one segment each.
+    {
+        {
+            std::ofstream file{"state.bin", std::ios::binary};
+            save_segments(file, 2, [&](const std::size_t i, portable_oarchive &oa) {
+                if (i == 0)
+                    oa << animals;
+                else
+                    oa << weights;
+            });
+        }
+
+        std::vector<animal> animals_copy;
+        std::vector<double> weights_copy;
+        segmented_reader in{"state.bin"};
+        in.load([&](const std::size_t i, mapped_iarchive &ia) {
+            if (i == 0)
+                ia >> animals_copy;
+            else
+                ia >> weights_copy;
+        });
+        std::cout << "objects: " << (animals_copy == animals && weights_copy == weights ? "same" : "DIFFERENT")
+                  << std::endl;
+
+        // Each segment is a portable archive of its own, so one can be read without the others.
+        mapped_iarchive ia{in.segment(1).data(), in.segment(1).size()};
+        std::vector<double> alone;
+        ia >> alone;
+        std::cout << "second segment alone: " << alone.size() << " weights" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,253 @@
+/**
+ * segmented_archive.h
+ *
+ * By Sebastian Raaphorst, 2018.
+ *
+ * Saving and loading independent parts of a state in parallel, as the segments of one file.
+ *
+ * A text_oarchive, like every archive, is written by one thread from start to end: each object's class ids and
+ * tracking depend on everything written before it. A segmented archive is instead a list of complete portable
+ * archives (portable_archive.h), one per segment, behind an index of their sizes:
+ *
+ *     index      a portable archive: a tag, and the size of each segment in bytes
+ *     segments   each one a portable archive of its own, starting on an 8-byte boundary
+ *
+ * Segments don't share anything, so each is serialized into a buffer of its own on its own thread, and the buffers
+ * are then written out after the index. On load, the file is mapped, and each segment is read in place by a
+ * mapped_iarchive (mapped_archive.h) on its own thread. The segments can be anything, e.g. separate top-level objects:
+ *
+ *     save_segments(file, 2, [&](const std::size_t i, portable_oarchive &oa) {
+ *         if (i == 0) oa << animals; else oa << weights;
+ *     });
+ *
+ *     segmented_reader in{"state.bin"};
+ *     in.load([&](const std::size_t i, mapped_iarchive &ia) {
+ *         if (i == 0) ia >> animals; else ia >> weights;
+ *     });
+ *
+ * or the shards of one vector, with save_sharded and load_sharded. As with anything else loaded by a mapped_iarchive,
+ * views point into the segmented_reader's mapping. An exception thrown while saving or loading a segment is
+ * rethrown by the calling thread, once every segment has finished.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/serialization/array_wrapper.hpp>
+#include <boost/serialization/collection_size_type.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include "mapped_archive.h"
+#include "portable_archive.h"
+
+/** Options for saving and loading segmented archives. **/
+struct segmented_archive_params {
+    // The number of threads. 0 means one per core.
+    unsigned threads = 0;
+
+    // For save_sharded, the number of segments to cut the vector into. 0 means one per thread.
+    std::size_t segments = 0;
+};
+
+namespace segmented_archive_detail {
+    // The first thing in the index.
+    constexpr std::uint32_t tag = 0x47535042;   // "BPSG"
+
+    inline unsigned threads(const segmented_archive_params params) {
+        return params.threads ? params.threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /** Call f(i) for every i in [0, n), on up to the given number of threads, and rethrow the first exception. **/
+    template<typename F>
+    void parallel_for(const std::size_t n, const unsigned threads, F &&f) {
+        std::atomic<std::size_t> next{0};
+        std::vector<std::exception_ptr> errors(n);
+        const auto work = [&] {
+            for (auto i = next++; i < n; i = next++) {
+                try {
+                    f(i);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < std::min<std::size_t>(threads, n); ++t)
+            workers.emplace_back(work);
+        work();
+        for (auto &w: workers)
+            w.join();
+
+        for (const auto &error: errors)
+            if (error)
+                std::rethrow_exception(error);
+    }
+
+    /** Zero bytes up to the next multiple of 8, after size bytes. **/
+    inline std::size_t padding(const std::size_t size) {
+        return (portable_archive_detail::max_alignment - size % portable_archive_detail::max_alignment)
+               % portable_archive_detail::max_alignment;
+    }
+}
+
+/**
+ * Save count segments to out, calling save(i, oa) to fill in segment i. The calls are made in parallel, each with a
+ * portable_oarchive of its own.
+ **/
+template<typename F>
+void save_segments(std::streambuf &out, const std::size_t count, F &&save, const segmented_archive_params params = {}) {
+    std::vector<std::string> segments(count);
+    segmented_archive_detail::parallel_for(count, segmented_archive_detail::threads(params), [&](const std::size_t i) {
+        std::stringbuf buf;
+        {
+            portable_oarchive oa{buf};
+            save(i, oa);
+        }
+        segments[i] = buf.str();
+    });
+
+    const auto write = [&out](const char *data, const std::size_t size) {
+        if (static_cast<std::size_t>(out.sputn(data, size)) != size)
+            boost::serialization::throw_exception(
+                    boost::archive::archive_exception(boost::archive::archive_exception::output_stream_error));
+    };
+    const char zeros[portable_archive_detail::max_alignment] = {};
+
+    std::vector<std::uint64_t> sizes;
+    for (const auto &segment: segments)
+        sizes.emplace_back(segment.size());
+    std::stringbuf index;
+    {
+        portable_oarchive oa{index};
+        oa << segmented_archive_detail::tag << sizes;
+    }
+    const auto head = index.str();
+    write(head.data(), head.size());
+    write(zeros, segmented_archive_detail::padding(head.size()));
+
+    for (auto &segment: segments) {
+        write(segment.data(), segment.size());
+        write(zeros, segmented_archive_detail::padding(segment.size()));
+        segment = std::string{};
+    }
+}
+
+template<typename F>
+void save_segments(std::ostream &os, const std::size_t count, F &&save, const segmented_archive_params params = {}) {
+    save_segments(*os.rdbuf(), count, std::forward<F>(save), params);
+}
+
+/** The segments of a segmented archive, in a file that it maps, or in memory that someone else owns. **/
+class segmented_reader {
+public:
+    /** Map the given file. Throws boost::interprocess::interprocess_exception if it can't. **/
+    explicit segmented_reader(const std::string &filename)
+            : file_{filename.c_str(), boost::interprocess::read_only},
+              region_{file_, boost::interprocess::read_only} {
+        read_index(static_cast<const char *>(region_.get_address()), region_.get_size());
+    }
+
+    /** Read from memory that must outlive the reader, and that starts on an 8-byte boundary. **/
+    segmented_reader(const char *data, const std::size_t size) {
+        read_index(data, size);
+    }
+
+    std::size_t size() const { return segments_.size(); }
+
+    /** The bytes of segment i: a portable archive. **/
+    std::string_view segment(const std::size_t i) const { return segments_[i]; }
+
+    /** Call load(i, ia) for every segment i, in parallel, each with a mapped_iarchive over the segment. **/
+    template<typename F>
+    void load(F &&load, const segmented_archive_params params = {}) const {
+        segmented_archive_detail::parallel_for(size(), segmented_archive_detail::threads(params),
+                                               [&](const std::size_t i) {
+                                                   mapped_iarchive ia{segments_[i].data(), segments_[i].size()};
+                                                   load(i, ia);
+                                               });
+    }
+
+private:
+    void read_index(const char *data, const std::size_t size) {
+        mapped_iarchive ia{data, size};
+        std::uint32_t tag;
+        std::vector<std::uint64_t> sizes;
+        ia >> tag;
+        if (tag != segmented_archive_detail::tag)
+            boost::serialization::throw_exception(
+                    boost::archive::archive_exception(boost::archive::archive_exception::invalid_signature));
+        ia >> sizes;
+
+        auto at = ia.position() + segmented_archive_detail::padding(ia.position());
+        for (const auto bytes: sizes) {
+            if (at > size || bytes > size - at)
+                boost::serialization::throw_exception(
+                        boost::archive::archive_exception(boost::archive::archive_exception::input_stream_error));
+            segments_.emplace_back(data + at, bytes);
+            at += bytes + segmented_archive_detail::padding(bytes);
+        }
+    }
+
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+    std::vector<std::string_view> segments_;
+};
+
+/**
+ * Save v to out as a segmented archive, cut into params.segments ranges of (nearly) equal size, one segment each.
+ * Vectors of bitwise serializable types are written as blocks, as portable_oarchive does.
+ **/
+template<typename T>
+void save_sharded(std::streambuf &out, const std::vector<T> &v, segmented_archive_params params = {}) {
+    const std::size_t count = std::max<std::size_t>(1, params.segments ? params.segments
+                                                                         : segmented_archive_detail::threads(params));
+    save_segments(out, count, [&](const std::size_t i, portable_oarchive &oa) {
+        const auto begin = v.size() * i / count;
+        const boost::serialization::collection_size_type size(v.size() * (i + 1) / count - begin);
+        oa << size;
+        if (size)
+            oa << boost::serialization::make_array(v.data() + begin, size);
+    }, params);
+}
+
+template<typename T>
+void save_sharded(std::ostream &os, const std::vector<T> &v, const segmented_archive_params params = {}) {
+    save_sharded(*os.rdbuf(), v, params);
+}
+
+/** Load a vector saved by save_sharded, loading its shards in parallel straight into their places in v. **/
+template<typename T>
+void load_sharded(const segmented_reader &in, std::vector<T> &v, const segmented_archive_params params = {}) {
+    // The size of each shard comes first in its segment, so they are all known before anything is loaded.
+    std::vector<std::size_t> starts{0};
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        mapped_iarchive ia{in.segment(i).data(), in.segment(i).size()};
+        boost::serialization::collection_size_type size;
+        ia >> size;
+        starts.emplace_back(starts.back() + size);
+    }
+
+    v.clear();
+    v.resize(starts.back());
+    in.load([&](const std::size_t i, mapped_iarchive &ia) {
+        boost::serialization::collection_size_type size;
+        ia >> size;
+        if (size)
+            ia >> boost::serialization::make_array(v.data() + starts[i], size);
+    }, params);
+}